@@ -207,6 +207,7 @@ main (int argc, const char *const argv[])
     HAVE_INOTIFY_INIT\n\
     HAVE_INOTIFY_INIT1\n\
     HAVE_INOTIFY_RM_WATCH\n\
+    HAVE_IO_URING\n\
     HAVE_J0\n\
     HAVE_J1\n\
     HAVE_JN\n\
@@ -262,6 +263,7 @@ main (int argc, const char *const argv[])
     HAVE_PIPE\n\
     HAVE_POLL\n\
     HAVE_POLL_H\n\
+    HAVE_POSIX_FADVISE\n\
     HAVE_PREAD\n\
     HAVE_PRLIMIT\n\
     HAVE_PWD_H\n\
@@ -315,6 +317,7 @@ main (int argc, const char *const argv[])
     HAVE_SEM_UNLINK\n\
     HAVE_SEM_WAIT\n\
     HAVE_SEND\n\
+    HAVE_SENDFILE\n\
     HAVE_SENDTO\n\
     HAVE_SETEGID\n\
     HAVE_SETENV\n\
@@ -368,6 +371,7 @@ main (int argc, const char *const argv[])
     HAVE_SINH\n\
     HAVE_SOCKET\n\
     HAVE_SOCKETPAIR\n\
+    HAVE_SPLICE\n\
     HAVE_STAT\n\
     HAVE_STAT_ST_ATIM\n\
     HAVE_STAT_ST_ATIMESPEC\n\
@@ -406,12 +410,14 @@ main (int argc, const char *const argv[])
     HAVE_SYNC\n\
     HAVE_SYSCONF\n\
     HAVE_SYSTEM\n\
+    HAVE_LINUX_IO_URING_H\n\
     HAVE_SYS_EPOLL_H\n\
     HAVE_SYS_INOTIFY_H\n\
     HAVE_SYS_IOCTL_H\n\
     HAVE_SYS_MMAN_H\n\
     HAVE_SYS_PARAM_H\n\
     HAVE_SYS_RESOURCE_H\n\
+    HAVE_SYS_SENDFILE_H\n\
     HAVE_SYS_SIGNALFD_H\n\
     HAVE_SYS_SOCKET_H\n\
     HAVE_SYS_STAT_H\n\
@@ -1516,6 +1522,13 @@ printf("(define-inline-constant HAVE_INOTIFY_RM_WATCH %s)\n",
   "#f"
 #endif
   );
+printf("(define-inline-constant HAVE_IO_URING %s)\n",
+#ifdef HAVE_IO_URING
+  "#t"
+#else
+  "#f"
+#endif
+  );
 printf("(define-inline-constant HAVE_J0 %s)\n",
 #ifdef HAVE_J0
   "#t"
@@ -1901,6 +1914,13 @@ printf("(define-inline-constant HAVE_POLL_H %s)\n",
   "#f"
 #endif
   );
+printf("(define-inline-constant HAVE_POSIX_FADVISE %s)\n",
+#ifdef HAVE_POSIX_FADVISE
+  "#t"
+#else
+  "#f"
+#endif
+  );
 printf("(define-inline-constant HAVE_PREAD %s)\n",
 #ifdef HAVE_PREAD
   "#t"
@@ -2272,6 +2292,13 @@ printf("(define-inline-constant HAVE_SEND %s)\n",
   "#f"
 #endif
   );
+printf("(define-inline-constant HAVE_SENDFILE %s)\n",
+#ifdef HAVE_SENDFILE
+  "#t"
+#else
+  "#f"
+#endif
+  );
 printf("(define-inline-constant HAVE_SENDTO %s)\n",
 #ifdef HAVE_SENDTO
   "#t"
@@ -2643,6 +2670,13 @@ printf("(define-inline-constant HAVE_SOCKETPAIR %s)\n",
   "#f"
 #endif
   );
+printf("(define-inline-constant HAVE_SPLICE %s)\n",
+#ifdef HAVE_SPLICE
+  "#t"
+#else
+  "#f"
+#endif
+  );
 printf("(define-inline-constant HAVE_STAT %s)\n",
 #ifdef HAVE_STAT
   "#t"
@@ -2909,6 +2943,13 @@ printf("(define-inline-constant HAVE_SYSTEM %s)\n",
   "#f"
 #endif
   );
+printf("(define-inline-constant HAVE_LINUX_IO_URING_H %s)\n",
+#ifdef HAVE_LINUX_IO_URING_H
+  "#t"
+#else
+  "#f"
+#endif
+  );
 printf("(define-inline-constant HAVE_SYS_EPOLL_H %s)\n",
 #ifdef HAVE_SYS_EPOLL_H
   "#t"
@@ -2951,6 +2992,13 @@ printf("(define-inline-constant HAVE_SYS_RESOURCE_H %s)\n",
   "#f"
 #endif
   );
+printf("(define-inline-constant HAVE_SYS_SENDFILE_H %s)\n",
+#ifdef HAVE_SYS_SENDFILE_H
+  "#t"
+#else
+  "#f"
+#endif
+  );
 printf("(define-inline-constant HAVE_SYS_SIGNALFD_H %s)\n",
 #ifdef HAVE_SYS_SIGNALFD_H
   "#t"
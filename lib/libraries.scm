@@ -96,6 +96,7 @@
      (vicare language-extensions tuples)
 
      (vicare checks)
+     (vicare debugging sampling-profiler)
 
      (vicare crypto randomisations low)
      (vicare crypto randomisations)
@@ -119,6 +120,7 @@
      (vicare containers bytevectors)
      (vicare containers auxiliary-syntaxes)
      (vicare containers weak-hashtables)
+     (vicare containers concurrent-hashtables)
      (vicare containers object-properties)
      (vicare containers knuth-morris-pratt)
      (vicare containers bytevector-compounds core)
@@ -206,7 +208,8 @@
      (vicare posix curl)
      (vicare posix wget)
      (vicare posix find)
-     (vicare build-tools automake))
+     (vicare build-tools automake)
+     (vicare build-tools parallel-build))
 
     ((WANT_GLIBC)
      (vicare glibc))
@@ -215,7 +218,8 @@
      (vicare gcc))
 
     ((WANT_POSIX WANT_LINUX)
-     (vicare linux))
+     (vicare linux)
+     (vicare linux async-io))
 
     ((WANT_READLINE)
      (vicare readline))
@@ -35,6 +35,9 @@
 (define-constant align-shift		(+ wordshift 1))
 ;;(define-constant pagesize		4096)
 (define-constant pageshift		12)
+;;Number of bits  to shift right a memory address to  obtain the index of its logic
+;;segment; it must match IK_SEGMENT_SHIFT in "internals.h".
+(define-constant segmentshift		22)
 
 (define (align n)
   (fxsll (fxsra (fx+ n (fxsub1 object-alignment))
@@ -439,6 +442,7 @@
 (define-constant pcb-interrupted		(fx* 10 wordsize))
 (define-constant pcb-base-rtd			(fx* 11 wordsize))
 (define-constant pcb-collect-key		(fx* 12 wordsize))
+(define-constant pcb-dirty-summary		(fx* 13 wordsize))
 
 
 ;;;; done
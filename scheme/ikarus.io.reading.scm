@@ -209,6 +209,93 @@
 
   #| end of module: %REFILL-INPUT-PORT-BYTEVECTOR-BUFFER |# )
 
+
+;;;; adaptive bytevector buffers for input ports
+;;
+;;Binary input ports with file descriptor  adapt to the size of the read requests:
+;;
+;;* Requests at least INPUT-BUFFER-BYPASS-THRESHOLD bytes wide, finding the buffer
+;;empty, are served by reading directly  into the destination bytevector: copying
+;;the data through the buffer would gain nothing.
+;;
+;;* The  buffer of input-only ports  grows to fit requests  wider than it, and it
+;;shrinks back when the requests become small.
+;;
+;;Ports whose buffer is smaller  than DEFAULT-BINARY-BLOCK-SIZE are never resized:
+;;small buffers are selected on purpose, for example by the test suites exercising
+;;the buffer refilling logic.
+;;
+
+(define (%adapt-input-buffer-to-request! port requested-count)
+  ;;To be called  when  the buffer of  PORT is empty  and REQUESTED-COUNT bytes are
+  ;;needed.  Maybe replace the buffer with a new one of different size.
+  ;;
+  (with-port-having-bytevector-buffer (port)
+    (when (and port.fd-device?
+	       port.is-input-only?
+	       ($fx= port.buffer.index port.buffer.used-size)
+	       ($fx>= port.buffer.size DEFAULT-BINARY-BLOCK-SIZE))
+      (let ((size port.buffer.size))
+	(cond ((and ($fx< size requested-count)
+		    ($fx< requested-count INPUT-BUFFER-BYPASS-THRESHOLD))
+	       ;;Grow the buffer  to the smallest power of two  times its size which
+	       ;;can hold the request.
+	       (let loop ((new-size ($fx* 2 size)))
+		 (if (or ($fx>= new-size requested-count)
+			 ($fx>= new-size INPUT-BUFFER-BYPASS-THRESHOLD))
+		     (begin
+		       (set! port.buffer ($make-bytevector ($fxmin new-size INPUT-BUFFER-BYPASS-THRESHOLD)))
+		       (port.buffer.reset-to-empty!))
+		   (loop ($fx* 2 new-size)))))
+	      ((and ($fx> size DEFAULT-BINARY-BLOCK-SIZE)
+		    ($fx< ($fx* 4 requested-count) size))
+	       ;;Halve the buffer.
+	       (set! port.buffer ($make-bytevector ($fxmax DEFAULT-BINARY-BLOCK-SIZE ($fxsra size 1))))
+	       (port.buffer.reset-to-empty!)))))))
+
+(define (%bypass-input-buffer? port requested-count)
+  ;;Return true if the request  of REQUESTED-COUNT bytes must be served by reading
+  ;;directly into the destination bytevector.
+  ;;
+  (with-port-having-bytevector-buffer (port)
+    (and port.fd-device?
+	 ($fx>= requested-count INPUT-BUFFER-BYPASS-THRESHOLD)
+	 ($fx= port.buffer.index port.buffer.used-size))))
+
+(define (%read-bypassing-buffer port dst.bv dst.start requested-count who)
+  ;;Read from the device  of PORT at most REQUESTED-COUNT bytes, storing them in
+  ;;DST.BV starting at index  DST.START; the buffer of PORT must be empty.  Read as
+  ;;many times as needed; stop early at the end of file or when reading would block.
+  ;;
+  ;;Return the number of bytes read, zero if the end of file was found before any
+  ;;byte; return the would-block object if reading would block before any byte.
+  ;;
+  (with-port-having-bytevector-buffer (port)
+    (port.buffer.reset-to-empty!)
+    (let loop ((dst.index	dst.start)
+	       (count		requested-count))
+      (if ($fxzero? count)
+	  ($fx- dst.index dst.start)
+	(let ((rv (guard (E ((i/o-eagain-error? E)
+			     WOULD-BLOCK-OBJECT)
+			    (else
+			     (raise E)))
+		    (port.read! dst.bv dst.index count))))
+	  (cond ((would-block-object? rv)
+		 (if ($fx= dst.index dst.start)
+		     rv
+		   ($fx- dst.index dst.start)))
+		((not (fixnum? rv))
+		 (assertion-violation who "invalid return value from read! procedure" rv))
+		((or ($fx> 0     rv)
+		     ($fx< count rv))
+		 (assertion-violation who "read! returned a value out of range" rv))
+		(($fxzero? rv)
+		 ($fx- dst.index dst.start))
+		(else
+		 (port.device.position.incr! rv)
+		 (loop ($fx+ dst.index rv) ($fx- count rv)))))))))
+
 
 ;;;; string buffer handling for input ports
 ;;
@@ -573,30 +660,70 @@
 				     retry-after-filling-buffer))
 	(define (compose-output)
 	  ($bytevector-reverse-and-concatenate output.len output.bvs))
-	(maybe-refill-bytevector-buffer-and-evaluate (port __module_who__)
-	  (data-is-needed-at:    port.buffer.index)
-	  ;;The buffer  was empty and  after attempting to  refill it: EOF  was found
-	  ;;without available data.
-	  (if-end-of-file: (if (zero? output.len)
-			       (eof-object)
-			     (compose-output)))
-	  ;;Attempting to refill the buffer caused an "&i/o-eagain" exception.  If we
-	  ;;are here:  the buffer is  now empty, but  maybe some data  was available,
-	  ;;even though not enough to satisfy the full request.
-	  ;;
-	  ;;If some  data is available  just return  it, else return  the would-block
-	  ;;object.
-	  (if-empty-buffer-and-refilling-would-block:
-	   (if (zero? output.len)
-	       (if (strict-r6rs)
-		   (retry-after-filling-buffer output.len output.bvs remaining-count)
-		 WOULD-BLOCK-OBJECT)
-	     (compose-output)))
-	  ;;The buffer was empty, but after refilling it: there is available data.
-	  (if-successful-refill: (data-available))
-	  ;;The buffer has available data without reading from the device.
-	  (if-available-data:    (data-available))
-	  ))))
+	(%adapt-input-buffer-to-request! port remaining-count)
+	(if (%bypass-input-buffer? port remaining-count)
+	    (%read-into-new-bytevector port output.len output.bvs remaining-count
+				       retry-after-filling-buffer)
+	  (maybe-refill-bytevector-buffer-and-evaluate (port __module_who__)
+	    (data-is-needed-at:    port.buffer.index)
+	    ;;The buffer  was empty and  after attempting to  refill it: EOF  was found
+	    ;;without available data.
+	    (if-end-of-file: (if (zero? output.len)
+				 (eof-object)
+			       (compose-output)))
+	    ;;Attempting to refill the buffer caused an "&i/o-eagain" exception.  If we
+	    ;;are here:  the buffer is  now empty, but  maybe some data  was available,
+	    ;;even though not enough to satisfy the full request.
+	    ;;
+	    ;;If some  data is available  just return  it, else return  the would-block
+	    ;;object.
+	    (if-empty-buffer-and-refilling-would-block:
+	     (if (zero? output.len)
+		 (if (strict-r6rs)
+		     (retry-after-filling-buffer output.len output.bvs remaining-count)
+		   WOULD-BLOCK-OBJECT)
+	       (compose-output)))
+	    ;;The buffer was empty, but after refilling it: there is available data.
+	    (if-successful-refill: (data-available))
+	    ;;The buffer has available data without reading from the device.
+	    (if-available-data:    (data-available))
+	    )))))
+
+  (define (%read-into-new-bytevector port output.len output.bvs remaining-count
+				     retry-after-filling-buffer)
+    ;;To be called when the  buffer is empty and the request is big:  read the data
+    ;;directly into a new bytevector, without copying it through the buffer.  At most
+    ;;INPUT-BUFFER-BYPASS-CHUNK-SIZE bytes are read into every new bytevector.
+    ;;
+    (let* ((bv.len ($fxmin remaining-count INPUT-BUFFER-BYPASS-CHUNK-SIZE))
+	   (bv     (make-bytevector bv.len))
+	   (rv     (%read-bypassing-buffer port bv 0 bv.len __module_who__)))
+      (cond ((would-block-object? rv)
+	     (if (zero? output.len)
+		 (if (strict-r6rs)
+		     (retry-after-filling-buffer output.len output.bvs remaining-count)
+		   WOULD-BLOCK-OBJECT)
+	       ($bytevector-reverse-and-concatenate output.len output.bvs)))
+	    (($fxzero? rv)
+	     (if (zero? output.len)
+		 (eof-object)
+	       ($bytevector-reverse-and-concatenate output.len output.bvs)))
+	    ((and ($fx= rv remaining-count)
+		  (null? output.bvs))
+	     ;;The whole request was read into BV: no concatenation needed.
+	     bv)
+	    (($fx= rv bv.len)
+	     ;;The chunk was filled: if the request is not satisfied, read another one.
+	     (if ($fx= rv remaining-count)
+		 ($bytevector-reverse-and-concatenate (+ output.len rv) (cons bv output.bvs))
+	       (%read-into-new-bytevector port (+ output.len rv) (cons bv output.bvs)
+					  ($fx- remaining-count rv)
+					  retry-after-filling-buffer)))
+	    (else
+	     (let ((tail (receive-and-return (tail)
+			     ($make-bytevector rv)
+			   ($bytevector-copy!/count bv 0 tail 0 rv))))
+	       ($bytevector-reverse-and-concatenate (+ output.len rv) (cons tail output.bvs)))))))
 
   (define (%data-available-in-buffer port output.len remaining-count output.bvs
 				     retry-after-filling-buffer)
@@ -699,23 +826,39 @@
 	(define (data-available)
 	  (%data-available-in-buffer port dst.bv dst.start dst.index remaining-count
 				     retry-after-filling-buffer))
-	(maybe-refill-bytevector-buffer-and-evaluate (port __module_who__)
-	  (data-is-needed-at: port.buffer.index)
-	  (if-end-of-file:
-	   (if ($fx= dst.index dst.start)
-	       (eof-object)
-	     ($fx- dst.index dst.start)))
-	  (if-empty-buffer-and-refilling-would-block:
-	   (if ($fx= dst.index dst.start)
-	       (if (strict-r6rs)
-		   (retry-after-filling-buffer dst.index remaining-count)
-		 WOULD-BLOCK-OBJECT)
-	     ($fx- dst.index dst.start)))
-	  (if-successful-refill:
-	   (data-available))
-	  (if-available-data:
-	   (data-available))
-	  ))))
+	(%adapt-input-buffer-to-request! port remaining-count)
+	(if (%bypass-input-buffer? port remaining-count)
+	    ;;The buffer is empty and the request is big: read the data directly into
+	    ;;DST.BV, without copying it through the buffer.
+	    (let ((rv (%read-bypassing-buffer port dst.bv dst.index remaining-count __module_who__)))
+	      (cond ((not (would-block-object? rv))
+		     (if (and ($fxzero? rv)
+			      ($fx= dst.index dst.start))
+			 (eof-object)
+		       ($fx- ($fx+ dst.index rv) dst.start)))
+		    (($fx= dst.index dst.start)
+		     (if (strict-r6rs)
+			 (retry-after-filling-buffer dst.index remaining-count)
+		       WOULD-BLOCK-OBJECT))
+		    (else
+		     ($fx- dst.index dst.start))))
+	  (maybe-refill-bytevector-buffer-and-evaluate (port __module_who__)
+	    (data-is-needed-at: port.buffer.index)
+	    (if-end-of-file:
+	     (if ($fx= dst.index dst.start)
+		 (eof-object)
+	       ($fx- dst.index dst.start)))
+	    (if-empty-buffer-and-refilling-would-block:
+	     (if ($fx= dst.index dst.start)
+		 (if (strict-r6rs)
+		     (retry-after-filling-buffer dst.index remaining-count)
+		   WOULD-BLOCK-OBJECT)
+	       ($fx- dst.index dst.start)))
+	    (if-successful-refill:
+	     (data-available))
+	    (if-available-data:
+	     (data-available))
+	    )))))
 
   (define (%data-available-in-buffer port dst.bv dst.start dst.index remaining-count
 				     retry-after-filling-buffer)
@@ -1429,34 +1572,39 @@
 		    1
 		    %read-char-from-port-with-fast-get-utf8-tag
 		    %peek-char-from-port-with-fast-get-utf8-tag
-		    %peek-char-from-port-with-utf8-codec))
+		    %peek-char-from-port-with-utf8-codec
+		    %read-utf8-ascii-run))
 	  ((FAST-GET-CHAR-TAG)
 	   (%get-it dst.past
 		    1
 		    %read-char-from-port-with-fast-get-char-tag
 		    %peek-char
-		    %peek-char/offset))
+		    %peek-char/offset
+		    %no-run))
 	  ((FAST-GET-LATIN-TAG)
 	   (%get-it dst.past
 		    1
 		    %read-char-from-port-with-fast-get-latin1-tag
 		    %peek-latin1
-		    %peek-latin1/offset))
+		    %peek-latin1/offset
+		    %no-run))
 	  ((FAST-GET-UTF16LE-TAG)
 	   (%get-it dst.past
 		    2
 		    %read-utf16le
 		    %peek-utf16le
-		    %peek-utf16le/offset))
+		    %peek-utf16le/offset
+		    %no-run))
 	  ((FAST-GET-UTF16BE-TAG)
 	   (%get-it dst.past
 		    2
 		    %read-utf16be
 		    %peek-utf16be
-		    %peek-utf16be/offset)))))
+		    %peek-utf16be/offset
+		    %no-run)))))
 
     (define-syntax-rule (%get-it ?dst.past ?offset-of-ch2 ?read-char-proc
-				 ?peek-char-proc ?peek-char/offset-proc)
+				 ?peek-char-proc ?peek-char/offset-proc ?read-run-proc)
       ;;Actually perform  the reading.  Loop reading  the next char and  updating the
       ;;port position;  read chars  are stored  into DST.STR.   If no  characters are
       ;;available return the EOF object or the would-block object.  Remember that, as
@@ -1486,15 +1634,25 @@
       ;;2-chars line-ending sequences always have a carriage return as first char and
       ;;we know, once the codec has been selected, the offset of such character.
       ;;
-      (let read-next-char ((dst.index dst.start))
+      ;;?READ-RUN-PROC must  be the identifier of  a macro storing in  DST.STR a run
+      ;;of characters  already available in  the buffer, which  need no end-of-line
+      ;;conversion; it must evaluate to the index of the next position in DST.STR to
+      ;;be filled.
+      ;;
+      (let read-next-char ((dst.index (?read-run-proc port dst.start ?dst.past)))
 	(define (%store-char-then-loop-or-return ch)
 	  ($string-set! dst.str dst.index ch)
 	  (let ((dst.index ($fxadd1 dst.index)))
 	    (if ($fx= dst.index ?dst.past)
 		($fx- dst.index dst.start)
-	      (read-next-char dst.index))))
-	(let ((ch (?peek-char-proc port who)))
+	      (read-next-char (?read-run-proc port dst.index ?dst.past)))))
+	(let ((ch (if ($fx= dst.index ?dst.past)
+		      ;;The run has filled DST.STR.
+		      #f
+		    (?peek-char-proc port who))))
 	  (cond
+	   ((not ch)
+	    ($fx- dst.index dst.start))
 	   ;;EOF without available characters: if  no characters were previously read
 	   ;;return the EOF object, else return the number of characters read.
 	   ;;
@@ -1597,6 +1755,25 @@
 
     ;;
 
+    (define-syntax-rule (%no-run port dst.index dst.past)
+      dst.index)
+
+    (define-syntax-rule (%read-utf8-ascii-run port dst.index dst.past)
+      ;;Store in DST.STR  the characters of the ASCII octets  at the beginning of the
+      ;;buffer; stop at the first carriage return if the port converts end-of-line
+      ;;sequences, the other ASCII octets need no conversion.
+      ;;
+      (with-port-having-bytevector-buffer (port)
+	(if (and ($fx< port.buffer.index port.buffer.used-size)
+		 (unicode::utf-8-single-octet? ($bytevector-u8-ref port.buffer port.buffer.index)))
+	    (let ((count (foreign-call "ikrt_utf8_ascii_run_to_string"
+				       port.buffer port.buffer.index port.buffer.used-size
+				       dst.str dst.index dst.past
+				       (not (%port-eol-style-is-none? port)))))
+	      (set! port.buffer.index ($fx+ port.buffer.index count))
+	      ($fx+ dst.index count))
+	  dst.index)))
+
     (define-syntax-rule (%read-char port who)
       (%read-char-from-port-with-fast-get-char-tag port who))
 
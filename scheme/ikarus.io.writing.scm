@@ -208,6 +208,17 @@
     ;;Write COUNT bytes from the bytevector SRC.BV to the binary output PORT starting
     ;;at offset SRC.START.  Return unspecified values.
     ;;
+    (with-port-having-bytevector-buffer (port)
+      (if (and ($fx> count (port.buffer.room))
+	       port.fd-device?
+	       ($fx= port.buffer.index port.buffer.used-size))
+	  ;;The bytes do not fit in the buffer, so we would have to flush it anyway: we
+	  ;;send the buffered bytes and the bytevector with the same system call.
+	  (%put-bytevector/gather port src.bv src.start count who)
+	(%put-bytevector/buffer port src.bv src.start count who)))
+    (values))
+
+  (define (%put-bytevector/buffer port src.bv src.start count who)
     (with-port-having-bytevector-buffer (port)
       ;;Write octets to the  buffer and, when the buffer fills  up, to the underlying
       ;;device.
@@ -236,8 +247,42 @@
 	       (%flush-output-port port who)
 	       (try-again-after-flushing-buffer ($fx+ src.start room)
 						($fx- count room)
-						(port.buffer.room))))))
-    (values))
+						(port.buffer.room)))))))
+
+  (define (%put-bytevector/gather port src.bv src.start count who)
+    ;;Write to the file descriptor of PORT the bytes in the buffer followed by COUNT
+    ;;bytes from SRC.BV starting at SRC.START, without copying them into the buffer.
+    ;;Leave the buffer empty.
+    ;;
+    ;;If an error occurs: the buffered bytes not yet written are left in the buffer,
+    ;;as %FLUSH-OUTPUT-PORT does, then an exception is raised.
+    ;;
+    (with-port-having-bytevector-buffer (port)
+      (let loop ((head.start	0)
+		 (head.count	port.buffer.used-size)
+		 (src.start	src.start)
+		 (count		count))
+	(unless (and ($fxzero? head.count)
+		     ($fxzero? count))
+	  (let ((rv (capi::platform-write2-fd port.device
+					      port.buffer head.start head.count
+					      src.bv src.start count)))
+	    (cond (($fx< rv 0)
+		   ($bytevector-copy!/count port.buffer head.start port.buffer 0 head.count)
+		   (set! port.buffer.index     head.count)
+		   (set! port.buffer.used-size head.count)
+		   (if ($fx= rv EAGAIN)
+		       (%raise-eagain-error who port port.id)
+		     (%raise-io-error who port.id rv (make-i/o-write-error))))
+		  (($fx< rv head.count)
+		   (port.device.position.incr! rv)
+		   (loop ($fx+ head.start rv) ($fx- head.count rv) src.start count))
+		  (else
+		   (port.device.position.incr! rv)
+		   (let ((written ($fx- rv head.count)))
+		     (loop ($fx+ head.start head.count) 0
+			   ($fx+ src.start written) ($fx- count written))))))))
+      (port.buffer.reset-to-empty!)))
 
   #| end of module |# )
 
@@ -683,8 +728,12 @@
      (%put-string port str start char-count __who__)))
 
   (define (%put-string port src.str src.start char-count who)
-    (define-syntax-rule (%put-it ?buffer-mode-line ?eol-bits ?put-char)
-      (let next-char ((src.index src.start)
+    (define-syntax-rule (%put-it ?buffer-mode-line ?eol-bits ?put-char ?put-run)
+      ;;?PUT-RUN must be the identifier of a macro writing to the buffer a run of
+      ;;characters  which need  no end-of-line  conversion; it  must evaluate  to the
+      ;;index of the next character in SRC.STR to be written.
+      ;;
+      (let next-char ((src.index (?put-run src.start ($fx+ src.start char-count) ?buffer-mode-line ?eol-bits))
 		      (src.past  ($fx+ src.start char-count)))
 	(unless ($fx= src.index src.past)
 	  (let* ((ch		($string-ref src.str src.index))
@@ -712,7 +761,31 @@
 	      (?put-char port ch code-point who))
 	    (when flush?
 	      (%flush-output-port port who)))
-	  (next-char ($fxadd1 src.index) src.past))))
+	  (next-char (?put-run ($fxadd1 src.index) src.past ?buffer-mode-line ?eol-bits) src.past))))
+    (define-syntax-rule (%no-run ?src.index ?src.past ?buffer-mode-line ?eol-bits)
+      ?src.index)
+    (define-syntax-rule (%put-utf8-ascii-run ?src.index ?src.past ?buffer-mode-line ?eol-bits)
+      ;;Write to the buffer  the octets of the ASCII characters  starting at ?SRC.INDEX;
+      ;;stop at the first linefeed if it needs conversion or flushing.
+      ;;
+      (let ((src.index ?src.index))
+	(with-port-having-bytevector-buffer (port)
+	  (if (and ($fx< src.index ?src.past)
+		   ($fx< ($char->fixnum ($string-ref src.str src.index)) #x80)
+		   ($fx< port.buffer.index port.buffer.size))
+	      (let* ((stop-at-linefeed? (or ?buffer-mode-line
+					    (not (or ($fxzero? ?eol-bits)
+						     ($fx= ?eol-bits EOL-LINEFEED-TAG)))))
+		     (count             (foreign-call "ikrt_string_ascii_run_to_utf8"
+						      src.str src.index ?src.past
+						      port.buffer port.buffer.index port.buffer.size
+						      stop-at-linefeed?))
+		     (buffer.past       ($fx+ port.buffer.index count)))
+		(set! port.buffer.index buffer.past)
+		(when ($fx> buffer.past port.buffer.used-size)
+		  (set! port.buffer.used-size buffer.past))
+		($fx+ src.index count))
+	    src.index))))
     (define-inline (%put-utf16le ?port ?ch ?code-point ?who)
       (%put-char-to-port-with-fast-utf16xe-tag ?port ?ch ?code-point ?who 'little))
     (define-inline (%put-utf16be ?port ?ch ?code-point ?who)
@@ -721,15 +794,15 @@
 	  (eol-bits          (%port-eol-style-bits port)))
       (%case-textual-output-port-fast-tag (port who)
 	((FAST-PUT-UTF8-TAG)
-	 (%put-it buffer-mode-line? eol-bits %put-char-to-port-with-fast-utf8-tag))
+	 (%put-it buffer-mode-line? eol-bits %put-char-to-port-with-fast-utf8-tag %put-utf8-ascii-run))
 	((FAST-PUT-CHAR-TAG)
-	 (%put-it buffer-mode-line? eol-bits %put-char-to-port-with-fast-char-tag))
+	 (%put-it buffer-mode-line? eol-bits %put-char-to-port-with-fast-char-tag %no-run))
 	((FAST-PUT-LATIN-TAG)
-	 (%put-it buffer-mode-line? eol-bits %put-char-to-port-with-fast-latin1-tag))
+	 (%put-it buffer-mode-line? eol-bits %put-char-to-port-with-fast-latin1-tag %no-run))
 	((FAST-PUT-UTF16LE-TAG)
-	 (%put-it buffer-mode-line? eol-bits %put-utf16le))
+	 (%put-it buffer-mode-line? eol-bits %put-utf16le %no-run))
 	((FAST-PUT-UTF16BE-TAG)
-	 (%put-it buffer-mode-line? eol-bits %put-utf16be))))
+	 (%put-it buffer-mode-line? eol-bits %put-utf16be %no-run))))
     (when ($port-buffer-mode-none? port)
       (%flush-output-port port who))
     (values))
@@ -37,6 +37,11 @@
 #include <sys/mman.h>
 #include <sys/types.h>
 #include <sys/time.h>
+#ifdef HAVE_PTHREAD
+#  include <pthread.h>
+#endif
+#include <signal.h>
+#include <errno.h>
 
 
 /** --------------------------------------------------------------------
@@ -51,6 +56,13 @@
 #define meta_symbol	5
 #define meta_count	6
 
+#if (meta_count != IK_GC_EVENT_META_COUNT)
+#  error "the number of meta page types must match IK_GC_EVENT_META_COUNT"
+#endif
+
+/* file descriptors */
+#define IK_NUM_TO_FD(fd)	IK_UNFIX(fd)
+
 
 /** --------------------------------------------------------------------
  ** Type definitions.
@@ -103,6 +115,17 @@ typedef struct gc_t {
   int		collect_gen;
   uint32_t	collect_gen_tag;
 
+  /* Statistics  for the  GC  events log  and  the generation  scheduling
+     policy.   "copied_bytes" is  the number  of bytes  of live  objects
+     moved  to  pages of  the  target  generation, indexed  by  meta  page
+     type;  "retagged_bytes" is  the  number of  bytes  of large  objects
+     promoted without moving them. */
+  ikuword_t	copied_bytes[meta_count];
+  ikuword_t	retagged_bytes;
+  ikuword_t	freed_pages;
+  ikuword_t	dirty_pages_scanned;
+  ikuword_t	guardians_processed;
+
   /* These fields are for the hash tables. */
   ikptr_t		tconc_ap;
   ikptr_t		tconc_ep;
@@ -134,10 +157,18 @@ static ikpcb_t *perform_garbage_collection (ikuword_t mem_req, ikptr_t s_request
 
 /* Prototypes for subroutines of "perform_garbage_collection()". */
 static int		collection_id_to_gen	(int id);
-static void		fix_weak_pointers	(gc_t *gc);
+static int		adaptive_collection_gen	(ikpcb_t * pcb);
+static void		update_generation_statistics (gc_t * gc, ikuword_t nursery_bytes);
+static void		log_gc_event		(gc_t * gc, ikuword_t pause_usecs);
+static void		fix_weak_pointers	(gc_t *gc, ikuword_t lo_idx, ikuword_t hi_idx);
 static inline void	collect_locatives	(gc_t*, ik_callback_locative_t*);
 static void		deallocate_unused_pages	(gc_t*);
-static void		fix_new_pages		(gc_t* gc);
+static void		fix_new_pages		(gc_t* gc, ikuword_t lo_idx, ikuword_t hi_idx);
+
+/* Type of the functions applied by "gc_parallel_sweep()" to a range of
+   page indexes. */
+typedef void gc_sweep_fun_t (gc_t * gc, ikuword_t lo_idx, ikuword_t hi_idx);
+static void		gc_parallel_sweep	(gc_t * gc, gc_sweep_fun_t * fun);
 static void		gc_finalize_guardians	(gc_t* gc);
 static void		gc_add_tconcs		(gc_t*);
 
@@ -160,6 +191,8 @@ static ikptr_t gather_live_object_proc(gc_t* gc, ikptr_t x);
 
 extern int		ik_garbage_collection_is_forbidden;
 extern ikuword_t	ik_customisable_heap_nursery_size;
+extern int		ik_gc_worker_threads;
+extern int		ik_gc_generation_policy;
 
 /* When true: internals inspection messages  are enabled.  It is used by
    the preprocessor macro "IK_RUNTIME_MESSAGE()". */
@@ -206,6 +239,16 @@ ikrt_disable_gc_integrity_checks (ikpcb_t * pcb) {
   return IK_VOID;
 }
 
+ikptr_t
+ikrt_gc_trust_dirty_summary (ikpcb_t * pcb)
+/* Called by the boot image, whose write barrier updates the dirty summary
+   along with the dirty vector: from now on "scan_dirty_pages()" visits only
+   the segments marked in the summary. */
+{
+  pcb->dirty_summary_trusted = 1;
+  return IK_VOID;
+}
+
 
 /** --------------------------------------------------------------------
  ** Helpers.
@@ -499,12 +542,16 @@ perform_garbage_collection (ikuword_t mem_req, ikptr_t s_requested_generation, i
   gc_t			gc;
   ikmemblock_t *	old_full_heap_nursery_segments;
   int			requested_generation;
+  ikuword_t		nursery_bytes;
 
-  {
-    requested_generation = (IK_FALSE == s_requested_generation)?	\
-      collection_id_to_gen(pcb->collection_id) : IK_UNFIX(s_requested_generation);
-    assert((0 <= requested_generation) && (requested_generation <= 4));
+  if (IK_FALSE != s_requested_generation) {
+    requested_generation = IK_UNFIX(s_requested_generation);
+  } else if (IK_GC_GENERATION_POLICY_ADAPTIVE == ik_gc_generation_policy) {
+    requested_generation = adaptive_collection_gen(pcb);
+  } else {
+    requested_generation = collection_id_to_gen(pcb->collection_id);
   }
+  assert((0 <= requested_generation) && (requested_generation <= 4));
   if (0) {
     fprintf(stderr, "%s: generation %d, customisable heap nursery size %lu\n",
 	    __func__, requested_generation, (unsigned long)ik_customisable_heap_nursery_size);
@@ -522,9 +569,13 @@ perform_garbage_collection (ikuword_t mem_req, ikptr_t s_requested_generation, i
     }
   }
 
-  { /* accounting */
+  { /* accounting;  the large strings  and bytevectors allocated  outside the
+       nursery since the last run count as nursery bytes. */
     ikuword_t bytes = ((ikuword_t)pcb->allocation_pointer) - ((ikuword_t)pcb->heap_nursery_hot_block_base);
+    bytes += pcb->large_data_bytes_since_gc;
+    pcb->large_data_bytes_since_gc = 0;
     register_to_collect_count(pcb, bytes);
+    nursery_bytes = bytes;
   }
 
   { /* initialise GC statistics */
@@ -550,6 +601,12 @@ perform_garbage_collection (ikuword_t mem_req, ikptr_t s_requested_generation, i
      later. */
   old_full_heap_nursery_segments  = pcb->full_heap_nursery_segments;
   pcb->full_heap_nursery_segments = NULL;
+  { /* The full nursery blocks are inspected, too. */
+    ikmemblock_t *	blk;
+    for (blk = old_full_heap_nursery_segments; blk; blk = blk->next) {
+      nursery_bytes += blk->size;
+    }
+  }
 
   /* Scan GC roots. */
   {
@@ -602,16 +659,17 @@ perform_garbage_collection (ikuword_t mem_req, ikptr_t s_requested_generation, i
 
   /* Does  not  allocate,  only  sets  to  BWP  the  locations  of  dead
      pointers. */
-  fix_weak_pointers(&gc);
+  gc_parallel_sweep(&gc, fix_weak_pointers);
 
   /* Now deallocate all unused pages. */
   deallocate_unused_pages(&gc);
 
-  fix_new_pages(&gc);
+  gc_parallel_sweep(&gc, fix_new_pages);
   gc_finalize_guardians(&gc);
 
   /* does not allocate */
   gc_add_tconcs(&gc);
+  update_generation_statistics(&gc, nursery_bytes);
 #if ((defined VICARE_DEBUGGING) && (defined VICARE_DEBUGGING_GC))
   ik_debug_message("done");
 #endif
@@ -732,6 +790,7 @@ perform_garbage_collection (ikuword_t mem_req, ikptr_t s_requested_generation, i
       pcb->collect_stime.tv_usec += 1000000;
       pcb->collect_stime.tv_sec  -= 1;
     }
+    log_gc_event(&gc, (ikuword_t)(1000000 * (rt1.tv_sec - rt0.tv_sec) + (rt1.tv_usec - rt0.tv_usec)));
     pcb->collect_rtime.tv_usec += rt1.tv_usec - rt0.tv_usec;
     pcb->collect_rtime.tv_sec += rt1.tv_sec - rt0.tv_sec;
     if (pcb->collect_rtime.tv_usec >= 1000000) {
@@ -765,6 +824,96 @@ collection_id_to_gen (int id)
   if ((id &   3) == 3)   { return 1; }	/*   3 == #b00000011 */
   return 0;
 }
+static int
+adaptive_collection_gen (ikpcb_t * pcb)
+/* Subroutine of  "perform_garbage_collection()".  Select the generation
+ * to inspect  according to  the statistics  gathered by  the previous
+ * collections.
+ *
+ *   For each generation  G we estimate the amount of  garbage that would
+ * be reclaimed by  collecting it: the bytes promoted into  G since its
+ * last collection, multiplied by the ratio of objects that did NOT survive
+ * the last  collections of G.   G is collected  when such amount  is at
+ * least its budget:
+ *
+ *    budget(G) = nursery size * 4^(G-1)
+ *
+ * which  mirrors  the  proportions  of   the  fixed  policy.   For  the
+ * oldest generation  the budget  is also  at least  the number  of bytes
+ * that  survived the  last full  collection: the  heap is  allowed to
+ * grow up to twice its live size before a full collection.
+ *
+ *   The oldest generation meeting its budget is selected.
+ */
+{
+  int	gen;
+  for (gen = IK_GC_GENERATION_OLDEST; gen > IK_GC_GENERATION_NURSERY; --gen) {
+    ikuword_t	budget  = ((ikuword_t)ik_customisable_heap_nursery_size) << (2 * (gen - 1));
+    ikuword_t	garbage = (pcb->gc_gen_pending_bytes[gen] / 1000) * (1000 - pcb->gc_gen_survival_permille[gen]);
+    if ((IK_GC_GENERATION_OLDEST == gen) && (budget < pcb->gc_live_bytes_after_full)) {
+      budget = pcb->gc_live_bytes_after_full;
+    }
+    if (garbage >= budget) {
+      IK_RUNTIME_MESSAGE("%s: selected generation %d, expected garbage %lu bytes, budget %lu bytes",
+			 __func__, gen, (ik_ulong)garbage, (ik_ulong)budget);
+      return gen;
+    }
+  }
+  return IK_GC_GENERATION_NURSERY;
+}
+static void
+update_generation_statistics (gc_t * gc, ikuword_t nursery_bytes)
+/* Subroutine  of "perform_garbage_collection()".   Update the statistics
+   used by the  adaptive generation scheduling policy.  They  are updated
+   whatever  the selected  policy, so  that  switching policy  at run-time
+   starts from meaningful values. */
+{
+  ikpcb_t *	pcb         = gc->pcb;
+  int		collect_gen = gc->collect_gen;
+  int		target_gen  = (collect_gen < IK_GC_GENERATION_OLDEST)? (1 + collect_gen) : IK_GC_GENERATION_OLDEST;
+  ikuword_t	inspected   = nursery_bytes;
+  ikuword_t	survived    = gc->retagged_bytes;
+  int		gen;
+  for (gen = 0; gen < meta_count; ++gen) {
+    survived += gc->copied_bytes[gen];
+  }
+  for (gen = 1; gen <= collect_gen; ++gen) {
+    inspected += pcb->gc_gen_pending_bytes[gen];
+    pcb->gc_gen_pending_bytes[gen] = 0;
+  }
+  if (IK_GC_GENERATION_OLDEST == collect_gen) {
+    inspected += pcb->gc_live_bytes_after_full;
+    pcb->gc_live_bytes_after_full = survived;
+  } else {
+    pcb->gc_gen_pending_bytes[target_gen] += survived;
+  }
+  if (inspected >= 1000) {
+    ikuword_t	permille = survived / (inspected / 1000);
+    if (permille > 1000) {
+      permille = 1000;
+    }
+    pcb->gc_gen_survival_permille[collect_gen] = (pcb->gc_gen_survival_permille[collect_gen] + permille) / 2;
+  }
+}
+static void
+log_gc_event (gc_t * gc, ikuword_t pause_usecs)
+/* Subroutine  of "perform_garbage_collection()".   Append a  record  to
+   the PCB's ring buffer of garbage collection events. */
+{
+  ikpcb_t *		pcb = gc->pcb;
+  ik_gc_event_t *	event = &(pcb->gc_event_log[pcb->gc_event_log_count % IK_GC_EVENT_LOG_LENGTH]);
+  int			i;
+  event->collection_id		= pcb->collection_id;
+  event->generation		= gc->collect_gen;
+  event->pause_usecs		= pause_usecs;
+  for (i=0; i<meta_count; ++i) {
+    event->copied_bytes[i]	= gc->copied_bytes[i];
+  }
+  event->freed_pages		= gc->freed_pages;
+  event->dirty_pages_scanned	= gc->dirty_pages_scanned;
+  event->guardians_processed	= gc->guardians_processed;
+  ++(pcb->gc_event_log_count);
+}
 static inline void
 collect_locatives (gc_t* gc, ik_callback_locative_t* loc)
 /* Subroutine of "perform_garbage_collection()". */
@@ -774,13 +923,13 @@ collect_locatives (gc_t* gc, ik_callback_locative_t* loc)
   }
 }
 static void
-fix_weak_pointers (gc_t* gc)
+fix_weak_pointers (gc_t* gc, ikuword_t lo_idx, ikuword_t hi_idx)
 /* Subroutine of  "perform_garbage_collection()".  Fix  the cars  of the
-   weak pairs. */
+   weak pairs  in the  pages with  index in the  range [LO_IDX,  HI_IDX).
+   Every page  is processed independently  from the others: it  is safe
+   to run this function concurrently on disjoint ranges. */
 {
   uint32_t *	segment_vec = gc->segment_vector;
-  ikuword_t	lo_idx      = IK_PAGE_INDEX(gc->pcb->memory_base);
-  ikuword_t	hi_idx      = IK_PAGE_INDEX(gc->pcb->memory_end);
   ikuword_t	page_idx    = lo_idx;
   int		collect_gen = gc->collect_gen;
   /* Iterate over the pages referenced by the segments vector. */
@@ -837,20 +986,20 @@ deallocate_unused_pages (gc_t* gc)
           /* do nothing yet */
         } else {
           ik_munmap_from_segment(IK_PAGE_POINTER_FROM_INDEX(page_idx), IK_PAGESIZE, pcb);
+	  ++(gc->freed_pages);
         }
       }
     }
   }
 }
 static void
-fix_new_pages (gc_t* gc)
-/* Subroutine of "perform_garbage_collection()". */
+fix_new_pages (gc_t* gc, ikuword_t lo_idx, ikuword_t hi_idx)
+/* Subroutine of "perform_garbage_collection()".  Clear the "new generation"
+   bit of  the pages with index  in the range [LO_IDX,  HI_IDX).  It is
+   safe to run this function concurrently on disjoint ranges. */
 {
-  ikpcb_t *	pcb         = gc->pcb;
-  uint32_t *	segment_vec = pcb->segment_vector;
-  ikptr_t		lo_idx      = IK_PAGE_INDEX(pcb->memory_base);
-  ikptr_t		hi_idx      = IK_PAGE_INDEX(pcb->memory_end);
-  ikptr_t		page_idx;
+  uint32_t *	segment_vec = gc->pcb->segment_vector;
+  ikuword_t	page_idx;
   for (page_idx=lo_idx; page_idx<hi_idx; ++page_idx) {
     segment_vec[page_idx] &= ~NEW_GEN_MASK;
     /*
@@ -867,7 +1016,6 @@ gc_finalize_guardians (gc_t* gc)
 {
   ik_ptr_page_t*	ls = gc->forward_list;
   int		tconc_count = 0;
-  uint32_t *	dirty_vec = (uint32_t *)(gc->pcb->dirty_vector);
   while(ls) {
     int i;
     for(i=0; i<ls->count; i++) {
@@ -881,15 +1029,235 @@ gc_finalize_guardians (gc_t* gc)
       IK_REF(p, off_car) = IK_FALSE_OBJECT;
       IK_REF(p, off_cdr) = IK_FALSE_OBJECT;
       IK_REF(tc, off_cdr) = p;
-      dirty_vec[IK_PAGE_INDEX(tc)]        = IK_DIRTY_WORD;
-      dirty_vec[IK_PAGE_INDEX(last_pair)] = IK_DIRTY_WORD;
+      IK_SIGNAL_DIRT_IN_PAGE_OF_POINTER(gc->pcb, tc);
+      IK_SIGNAL_DIRT_IN_PAGE_OF_POINTER(gc->pcb, last_pair);
     }
     ik_ptr_page_t* next = ls->next;
     ik_munmap((ikptr_t)ls, IK_PAGESIZE);
     ls = next;
   }
+  gc->guardians_processed = tconc_count;
+}
+
+
+/** --------------------------------------------------------------------
+ ** Parallel sweeping of the page vectors.
+ ** ----------------------------------------------------------------- */
+
+/* After  the live  objects have  been  traced: some  phases of  garbage
+ * collection visit  every slot in the  segments vector, from the  page at
+ * "pcb->memory_base" to the page  at "pcb->memory_end".  With heaps of
+ * several GiB  this is  millions of pages;  such phases  do not allocate
+ * and every page  is processed independently from the  others, so we can
+ * split the range among "ik_gc_worker_threads" threads.
+ *
+ *   The  result  is  the  same  as  the one  of  the  serial  sweep:  the
+ * functions  applied to  the ranges  must  touch only  the pages  in the
+ * range, and only read data that no other range writes.
+ *
+ *   The tracing  of live objects  is NOT  parallelised: moving an  object
+ * requires exclusive  access to the meta  pages and to the  "queues" in
+ * the GC struct.
+ *
+ *   Threads are available only when Vicare is configured with the pthread
+ * library  (the "--with-pthread" option  of "configure");  otherwise the
+ * sweeps are always serial.
+ */
+
+/* Sweeping a range of pages is cheap: it is worth using threads only when
+   every thread has at least this number of pages to visit. */
+#define GC_PARALLEL_SWEEP_MIN_PAGES_PER_THREAD	(16 * IK_NUMBER_OF_PAGES_PER_SEGMENT)
+
+typedef struct gc_sweep_task_t {
+  gc_sweep_fun_t *	fun;
+  gc_t *		gc;
+  ikuword_t		lo_idx;
+  ikuword_t		hi_idx;
+} gc_sweep_task_t;
+
+#ifdef HAVE_PTHREAD
+
+/* The worker threads are  created the first time they are needed and then
+ * kept  waiting  on  a condition  variable  between  sweeps,  so  a
+ * collection does not pay for thread creation.  Every sweep is a "round":
+ * the collector thread publishes the tasks, increments the round number
+ * and wakes up the workers; the worker with index I runs the task at
+ * index I, if any, while the collector runs the task at index zero.
+ *
+ *   In the child of  a "fork()" the worker threads do not exist: the pool
+ * is reset by an "atfork" handler and the workers are created again.
+ */
+typedef struct gc_worker_t {
+  ikuword_t		index;
+  /* Number of the last round seen by this worker. */
+  ikuword_t		round;
+} gc_worker_t;
+
+typedef struct gc_worker_pool_t {
+  pthread_mutex_t	mutex;
+  pthread_cond_t	work_available;
+  pthread_cond_t	work_done;
+  /* Number of running workers; the worker with index I is at slot I, for
+     I in the range [1, num_of_workers]. */
+  ikuword_t		num_of_workers;
+  gc_worker_t		workers[IK_GC_MAX_WORKER_THREADS];
+  /* The tasks of the current round. */
+  gc_sweep_task_t *	tasks;
+  ikuword_t		num_of_tasks;
+  /* Number of tasks of the current round not yet completed by the workers. */
+  ikuword_t		pending_tasks;
+  ikuword_t		round;
+  int			atfork_registered;
+} gc_worker_pool_t;
+
+static gc_worker_pool_t gc_worker_pool = {
+  .mutex		= PTHREAD_MUTEX_INITIALIZER,
+  .work_available	= PTHREAD_COND_INITIALIZER,
+  .work_done		= PTHREAD_COND_INITIALIZER
+};
+
+static void
+gc_run_sweep_task (gc_sweep_task_t * task)
+{
+  task->fun(task->gc, task->lo_idx, task->hi_idx);
+}
+static void *
+gc_sweep_worker (void * arg)
+{
+  gc_worker_pool_t *	pool   = &gc_worker_pool;
+  gc_worker_t *		worker = arg;
+  for (;;) {
+    gc_sweep_task_t *	task;
+    pthread_mutex_lock(&pool->mutex);
+    while (worker->round == pool->round) {
+      pthread_cond_wait(&pool->work_available, &pool->mutex);
+    }
+    worker->round = pool->round;
+    task = (worker->index < pool->num_of_tasks)? &pool->tasks[worker->index] : NULL;
+    pthread_mutex_unlock(&pool->mutex);
+    if (task) {
+      gc_run_sweep_task(task);
+      pthread_mutex_lock(&pool->mutex);
+      if (0 == --pool->pending_tasks) {
+	pthread_cond_signal(&pool->work_done);
+      }
+      pthread_mutex_unlock(&pool->mutex);
+    }
+  }
+  return NULL;
+}
+static void
+gc_worker_pool_atfork_child (void)
+/* The child of a "fork()" has only  the thread that called it: forget the
+   workers  and reinitialise the  synchronisation objects,  which may have
+   been copied in a locked state. */
+{
+  gc_worker_pool_t *	pool = &gc_worker_pool;
+  pthread_mutex_init(&pool->mutex, NULL);
+  pthread_cond_init(&pool->work_available, NULL);
+  pthread_cond_init(&pool->work_done, NULL);
+  pool->num_of_workers	= 0;
+  pool->num_of_tasks	= 0;
+  pool->pending_tasks	= 0;
+}
+static ikuword_t
+gc_worker_pool_grow (ikuword_t num_of_workers)
+/* Make sure  that at least NUM_OF_WORKERS  worker threads are  running;
+   return the number of running workers, which is less than requested if
+   a thread cannot be created.  The workers block all the signals: signal
+   handlers must run in the Scheme thread. */
+{
+  gc_worker_pool_t *	pool = &gc_worker_pool;
+  if (pool->num_of_workers < num_of_workers) {
+    sigset_t	all_signals, saved_signals;
+    if (! pool->atfork_registered) {
+      pool->atfork_registered = (0 == pthread_atfork(NULL, NULL, gc_worker_pool_atfork_child));
+      if (! pool->atfork_registered) {
+	/* Without the handler a forked child would wait forever for workers
+	   that do not exist. */
+	return 0;
+      }
+    }
+    sigfillset(&all_signals);
+    pthread_sigmask(SIG_SETMASK, &all_signals, &saved_signals);
+    while (pool->num_of_workers < num_of_workers) {
+      gc_worker_t *	worker = &pool->workers[1 + pool->num_of_workers];
+      pthread_t		thread;
+      worker->index = 1 + pool->num_of_workers;
+      /* Only the collector thread modifies the round number, so we can read
+	 it without locking. */
+      worker->round = pool->round;
+      if (pthread_create(&thread, NULL, gc_sweep_worker, worker)) {
+	IK_RUNTIME_MESSAGE("%s: failed to create GC worker thread", __func__);
+	break;
+      }
+      pthread_detach(thread);
+      ++(pool->num_of_workers);
+    }
+    pthread_sigmask(SIG_SETMASK, &saved_signals, NULL);
+  }
+  return pool->num_of_workers;
 }
 
+#endif /* HAVE_PTHREAD */
+
+static void
+gc_parallel_sweep (gc_t * gc, gc_sweep_fun_t * fun)
+/* Apply FUN  to all the pages  between "pcb->memory_base" and
+   "pcb->memory_end", splitting the range among multiple threads if
+   configured to do so. */
+{
+#ifdef HAVE_PTHREAD
+  ikuword_t	lo_idx         = IK_PAGE_INDEX(gc->pcb->memory_base);
+  ikuword_t	hi_idx         = IK_PAGE_INDEX(gc->pcb->memory_end);
+  ikuword_t	num_of_pages   = hi_idx - lo_idx;
+  ikuword_t	num_of_threads = (ikuword_t)ik_gc_worker_threads;
+  if (num_of_threads > (num_of_pages / GC_PARALLEL_SWEEP_MIN_PAGES_PER_THREAD)) {
+    num_of_threads = num_of_pages / GC_PARALLEL_SWEEP_MIN_PAGES_PER_THREAD;
+  }
+  if (num_of_threads > 1) {
+    num_of_threads = 1 + gc_worker_pool_grow(num_of_threads - 1);
+  }
+  if (num_of_threads < 2) {
+    fun(gc, lo_idx, hi_idx);
+  } else {
+    gc_worker_pool_t *	pool = &gc_worker_pool;
+    gc_sweep_task_t	tasks[IK_GC_MAX_WORKER_THREADS];
+    ikuword_t		pages_per_thread = (num_of_pages + num_of_threads - 1) / num_of_threads;
+    ikuword_t		i;
+    assert(num_of_threads <= IK_GC_MAX_WORKER_THREADS);
+    for (i=0; i<num_of_threads; ++i) {
+      tasks[i].fun    = fun;
+      tasks[i].gc     = gc;
+      tasks[i].lo_idx = lo_idx + i * pages_per_thread;
+      tasks[i].hi_idx = tasks[i].lo_idx + pages_per_thread;
+      if (tasks[i].hi_idx > hi_idx) {
+	tasks[i].hi_idx = hi_idx;
+      }
+    }
+    pthread_mutex_lock(&pool->mutex);
+    pool->tasks		= tasks;
+    pool->num_of_tasks	= num_of_threads;
+    pool->pending_tasks	= num_of_threads - 1;
+    ++(pool->round);
+    pthread_cond_broadcast(&pool->work_available);
+    pthread_mutex_unlock(&pool->mutex);
+    /* The task at index zero is run by the current thread. */
+    gc_run_sweep_task(&tasks[0]);
+    pthread_mutex_lock(&pool->mutex);
+    while (pool->pending_tasks) {
+      pthread_cond_wait(&pool->work_done, &pool->mutex);
+    }
+    pool->tasks		= NULL;
+    pool->num_of_tasks	= 0;
+    pthread_mutex_unlock(&pool->mutex);
+  }
+#else
+  fun(gc, IK_PAGE_INDEX(gc->pcb->memory_base), IK_PAGE_INDEX(gc->pcb->memory_end));
+#endif
+}
+
+
 
 /** --------------------------------------------------------------------
  ** Collection subroutines: Scheme stack.
@@ -1418,6 +1786,14 @@ move_tconc (ikptr_t tc, ik_ptr_page_t* ls)
  ** Keeping alive objects: main function.
  ** ----------------------------------------------------------------- */
 
+/* Strings and bytevectors whose data area is at least this number of bytes
+   are stored in  their own run of pages marked as  "large object"; once
+   there, they are promoted to older  generations by retagging the pages
+   rather than by copying them.   MAKE-STRING and MAKE-BYTEVECTOR allocate
+   them  there  from  the  start:  see  "ikrt_make_large_bytevector()" and
+   "ikrt_make_large_string()". */
+#define LARGE_DATA_OBJECT_THRESHOLD	(16 * IK_PAGESIZE)
+
 /* Prototypes for subroutines of "gather_live_object()". */
 static void		gather_live_list	(gc_t* gc, unsigned segment_bits, ikptr_t X, ikptr_t* loc);
 static inline void	gc_tconc_push		(gc_t* gc, ikptr_t tcbucket);
@@ -1426,6 +1802,8 @@ static inline ikptr_t	gc_alloc_new_data	(ikuword_t aligned_size, gc_t* gc);
 static inline ikptr_t	gc_alloc_new_ptr	(ikuword_t aligned_size, gc_t* gc);
 static inline ikptr_t	gc_alloc_new_large_ptr	(ikuword_t number_of_bytes, gc_t* gc);
 static inline void	enqueue_large_ptr	(ikptr_t mem, ikuword_t aligned_size, gc_t* gc);
+static inline ikptr_t	gc_alloc_new_large_data	(ikuword_t aligned_size, gc_t* gc);
+static inline void	promote_large_data	(ikptr_t mem, ikuword_t aligned_size, gc_t* gc);
 static inline ikptr_t	gc_alloc_new_symbol_record (gc_t* gc);
 static inline ikptr_t	gc_alloc_new_pair	(gc_t* gc);
 static inline ikptr_t	gc_alloc_new_weak_pair	(gc_t* gc);
@@ -2026,7 +2404,19 @@ gather_live_object_proc (gc_t* gc, ikptr_t X)
     if (IK_IS_FIXNUM(first_word)) {
       ikuword_t	len    = IK_UNFIX(first_word);
       ikuword_t	memreq = IK_ALIGN(len * IK_STRING_CHAR_SIZE + disp_string_data);
-      ikptr_t	Y      = gc_alloc_new_data(memreq, gc) | string_tag;
+      ikptr_t	Y;
+      if (memreq >= LARGE_DATA_OBJECT_THRESHOLD) {
+	if (LARGE_OBJECT_TAG == (page_sbits & LARGE_OBJECT_MASK)) {
+	  /* Big string  already stored in  pages marked as  "large object":
+	     we do not move it around, we just promote its pages. */
+	  promote_large_data(X - string_tag, memreq, gc);
+	  return X;
+	} else {
+	  Y = gc_alloc_new_large_data(memreq, gc) | string_tag;
+	}
+      } else {
+	Y = gc_alloc_new_data(memreq, gc) | string_tag;
+      }
       IK_REF(Y, off_string_length) = first_word;
       memcpy((uint8_t*)(ikuword_t)(Y + off_string_data),
              (uint8_t*)(ikuword_t)(X + off_string_data),
@@ -2044,7 +2434,19 @@ gather_live_object_proc (gc_t* gc, ikptr_t X)
   case bytevector_tag: {
     ikuword_t	len    = IK_UNFIX(first_word);
     ikuword_t	memreq = IK_ALIGN(len + disp_bytevector_data + 1);
-    ikptr_t	Y = gc_alloc_new_data(memreq, gc) | bytevector_tag;
+    ikptr_t	Y;
+    if (memreq >= LARGE_DATA_OBJECT_THRESHOLD) {
+      if (LARGE_OBJECT_TAG == (page_sbits & LARGE_OBJECT_MASK)) {
+	/* Big bytevector already stored  in pages marked as "large object":
+	   we do not move it around, we just promote its pages. */
+	promote_large_data(X - bytevector_tag, memreq, gc);
+	return X;
+      } else {
+	Y = gc_alloc_new_large_data(memreq, gc) | bytevector_tag;
+      }
+    } else {
+      Y = gc_alloc_new_data(memreq, gc) | bytevector_tag;
+    }
     IK_REF(Y, off_bytevector_length) = first_word;
     memcpy((uint8_t*)(ikuword_t)(Y + off_bytevector_data),
            (uint8_t*)(ikuword_t)(X + off_bytevector_data),
@@ -2480,6 +2882,7 @@ gc_alloc_new_large_ptr (ikuword_t number_of_bytes, gc_t* gc)
   ikptr_t		mem;
   memreq = IK_ALIGN_TO_NEXT_PAGE(number_of_bytes);
   mem    = ik_mmap_typed(memreq, POINTERS_MT | LARGE_OBJECT_TAG | gc->collect_gen_tag, gc->pcb);
+  gc->copied_bytes[meta_ptrs] += number_of_bytes;
   /* Reset to zero  the portion of memory  that will not be  used by the
      large object. */
   bzero((uint8_t*)(ikuword_t)(mem+number_of_bytes), memreq-number_of_bytes);
@@ -2508,8 +2911,15 @@ enqueue_large_ptr (ikptr_t mem, ikuword_t aligned_size, gc_t* gc)
 {
   ikuword_t	page_idx = IK_PAGE_INDEX(mem);
   ikuword_t	page_end = IK_PAGE_INDEX(mem+aligned_size-1);
+  uint32_t	new_bits = POINTERS_MT | LARGE_OBJECT_TAG | gc->collect_gen_tag;
+  /* When collecting  the oldest generation the  target generation is the
+     collected one: do not promote and count the object twice. */
+  if (new_bits == gc->segment_vector[page_idx]) {
+    return;
+  }
+  gc->retagged_bytes += aligned_size;
   for (; page_idx <= page_end; ++page_idx) {
-    gc->segment_vector[page_idx] = POINTERS_MT | LARGE_OBJECT_TAG | gc->collect_gen_tag;
+    gc->segment_vector[page_idx] = new_bits;
   }
   {
     qupages_t *	qu;
@@ -2521,6 +2931,46 @@ enqueue_large_ptr (ikptr_t mem, ikuword_t aligned_size, gc_t* gc)
   }
 }
 static inline ikptr_t
+gc_alloc_new_large_data (ikuword_t aligned_size, gc_t* gc)
+/* Alloc memory pages  in which a large data object  (string or bytevector)
+   will be stored; return a pointer to the first allocated page.  The pages
+   are marked in the segments vector as  "large object", this will prevent
+   later  such object  to  be  moved around.   The  data  area is  never
+   scanned, so it is not registered in the queues of "collect_loop()". */
+{
+  ikuword_t	memreq = IK_ALIGN_TO_NEXT_PAGE(aligned_size);
+  ikptr_t	mem    = ik_mmap_typed(memreq, DATA_MT | LARGE_OBJECT_TAG | gc->collect_gen_tag, gc->pcb);
+  gc->copied_bytes[meta_data] += aligned_size;
+  /* Reset to zero  the portion of memory  that will not be  used by the
+     large object. */
+  bzero((uint8_t*)(ikuword_t)(mem+aligned_size), memreq-aligned_size);
+  /* Retake   the   segments   vector  because   memory   allocated   by
+     "ik_mmap_typed()" might  have caused  the reallocation of  the page
+     vectors. */
+  gc->segment_vector = gc->pcb->segment_vector;
+  return mem;
+}
+static inline void
+promote_large_data (ikptr_t mem, ikuword_t aligned_size, gc_t* gc)
+/* Assume that "mem" references a large data object that is already stored
+   in memory pages marked as "large object".  Such objects are not copied
+   by the  garbage collector:  we promote  them to  the next  generation by
+   retagging their pages in the segments vector. */
+{
+  ikuword_t	page_idx = IK_PAGE_INDEX(mem);
+  ikuword_t	page_end = IK_PAGE_INDEX(mem+aligned_size-1);
+  uint32_t	new_bits = DATA_MT | LARGE_OBJECT_TAG | gc->collect_gen_tag;
+  /* When collecting  the oldest generation the  target generation is the
+     collected one: do not promote and count the object twice. */
+  if (new_bits == gc->segment_vector[page_idx]) {
+    return;
+  }
+  gc->retagged_bytes += aligned_size;
+  for (; page_idx <= page_end; ++page_idx) {
+    gc->segment_vector[page_idx] = new_bits;
+  }
+}
+static inline ikptr_t
 gc_alloc_new_symbol_record (gc_t* gc)
 /* Reserve enough  room in the current  meta page for symbols  to hold a
    Scheme symbol's record.  Return an untagged pointer to the first word
@@ -2553,6 +3003,7 @@ gc_alloc_new_weak_pair(gc_t* gc)
   ikptr_t		ap  = meta->ap;		/* meta page alloc pointer */
   ikptr_t		ep  = meta->ep;		/* meta page end pointer */
   ikptr_t		nap = ap + pair_size;	/* meta page new alloc pointer */
+  gc->copied_bytes[meta_weak] += pair_size;
   if (nap > ep) {
     /* There is not  enough room, in the current meta  page, for another
        pair; we have to allocate a new page. */
@@ -2597,6 +3048,7 @@ gc_alloc_new_code (ikuword_t aligned_size, gc_t* gc)
   } else { /* More than one page needed. */
     ikuword_t	memreq	= IK_ALIGN_TO_NEXT_PAGE(aligned_size);
     ikptr_t	mem	= ik_mmap_code(memreq, gc->collect_gen, gc->pcb);
+    gc->copied_bytes[meta_code] += aligned_size;
     /* Reset to  zero the portion of  allocated memory that will  not be
        used by the code object. */
     bzero((char*)(ikuword_t)(mem+aligned_size), memreq-aligned_size);
@@ -2630,6 +3082,7 @@ meta_alloc (ikuword_t aligned_size, gc_t* gc, int meta_id)
   ikptr_t		ap   = meta->ap;		/* allocation pointer */
   ikptr_t		ep   = meta->ep;		/* end pointer */
   ikptr_t		nap  = ap + aligned_size;	/* new alloc pointer */
+  gc->copied_bytes[meta_id] += aligned_size;
   if (nap > ep) {
     /* Not enough room. */
     return meta_alloc_extending(aligned_size, gc, meta_id);
@@ -3003,6 +3456,12 @@ static const uint32_t CLEANUP_MASK[IK_GC_GENERATION_COUNT] = {
   0xFFFFFFFF
 };
 
+/* Number of  dirty vector  slots tested as  a single  block before
+   looking at the individual pages. */
+#define DIRTY_SCAN_BLOCK_PAGES		64
+
+static void scan_dirty_page_range   (gc_t* gc, ikuword_t lo_idx, ikuword_t hi_idx, uint32_t mask);
+static inline void scan_dirty_page_at_index (gc_t* gc, ikuword_t page_idx, uint32_t mask);
 static void scan_dirty_code_page     (gc_t* gc, ikuword_t page_idx);
 static void scan_dirty_pointers_page (gc_t* gc, ikuword_t page_idx, uint32_t mask);
 
@@ -3019,45 +3478,108 @@ scan_dirty_pages (gc_t* gc)
    objects  themselves composed  of immediate  Scheme objects  or tagged
    pointers (pairs, vectors, structs, records, compnums, cflonums); such
    page becomes dirty when a word is mutated at run-time.
-*/
+
+   Most of the heap is usually clean, so we visit only the segments marked
+   in the dirty  summary, which the write barrier updates  along with the
+   dirty vector.  After scanning a segment we clear its summary byte if no
+   page in it is left dirty.  This way the work of a minor collection is
+   driven by the number of dirty segments, not by the number of pages in
+   the heap.
+
+   When the boot image has not declared that its write barrier updates the
+   summary: we visit the whole dirty vector. */
+{
+  ikpcb_t *	pcb         = gc->pcb;
+  uint32_t	mask        = DIRTY_MASK[gc->collect_gen];
+  if (0 == mask) {
+    /* When  collecting  the oldest  generation  no  page is  older  than
+       the collected ones: there is nothing to do. */
+    return;
+  }
+  if (pcb->dirty_summary_trusted) {
+    ikuword_t	lo_seg = IK_SEGMENT_INDEX(pcb->memory_base);
+    ikuword_t	hi_seg = IK_SEGMENT_INDEX(pcb->memory_end);
+    ikuword_t	seg_idx;
+    for (seg_idx = lo_seg; seg_idx < hi_seg; ++seg_idx) {
+      /* The scan might have  allocated new memory, so we must retake the
+	 dirty summary and the dirty vector at every iteration. */
+      if (IK_PURE_SUMMARY_BYTE != ((uint8_t *)pcb->dirty_summary)[seg_idx]) {
+	ikuword_t	lo_idx = seg_idx * IK_NUMBER_OF_PAGES_PER_SEGMENT;
+	ikuword_t	hi_idx = lo_idx  + IK_NUMBER_OF_PAGES_PER_SEGMENT;
+	uint32_t *	dirty_vec;
+	uint32_t	seg_dbits = 0;
+	ikuword_t	i;
+	scan_dirty_page_range(gc, lo_idx, hi_idx, mask);
+	dirty_vec = (uint32_t*)pcb->dirty_vector;
+	for (i = lo_idx; i < hi_idx; ++i) {
+	  seg_dbits |= dirty_vec[i];
+	}
+	if (0 == seg_dbits) {
+	  ((uint8_t *)pcb->dirty_summary)[seg_idx] = IK_PURE_SUMMARY_BYTE;
+	}
+      }
+    }
+  } else {
+    scan_dirty_page_range(gc, IK_PAGE_INDEX(pcb->memory_base), IK_PAGE_INDEX(pcb->memory_end), mask);
+  }
+}
+static void
+scan_dirty_page_range (gc_t* gc, ikuword_t lo_idx, ikuword_t hi_idx, uint32_t mask)
+/* Subroutine of "scan_dirty_pages()".  Scan the dirty pages with index in
+   the range [LO_IDX, HI_IDX).  We visit the dirty vector in blocks of
+   "DIRTY_SCAN_BLOCK_PAGES" slots:  the slots of a block are ORed together
+   in a tight loop and the whole block  is skipped when nothing in it is
+   selected by the mask. */
 {
   ikpcb_t *	pcb         = gc->pcb;
-  ikuword_t	lo_idx      = IK_PAGE_INDEX(pcb->memory_base);
-  ikuword_t	hi_idx      = IK_PAGE_INDEX(pcb->memory_end);
   uint32_t *	dirty_vec   = (uint32_t*)pcb->dirty_vector;
-  uint32_t *	segment_vec = pcb->segment_vector;
-  uint32_t	collect_gen = gc->collect_gen;
-  uint32_t	mask        = DIRTY_MASK[collect_gen];
   ikuword_t	page_idx;
-  for (page_idx = lo_idx; page_idx < hi_idx; ++page_idx) {
-    if (dirty_vec[page_idx] & mask) {
-      uint32_t page_bits               = segment_vec[page_idx];
-      uint32_t page_generation_number  = page_bits & GEN_MASK;
-      if (page_generation_number > collect_gen) {
-        uint32_t type = page_bits & TYPE_MASK;
-        if (type == POINTERS_TYPE) {
-          scan_dirty_pointers_page(gc, page_idx, mask);
-          dirty_vec   = (uint32_t*)pcb->dirty_vector;
-          segment_vec = pcb->segment_vector;
-        }
-        else if (type == SYMBOLS_TYPE) {
-          scan_dirty_pointers_page(gc, page_idx, mask);
-          dirty_vec   = (uint32_t*)pcb->dirty_vector;
-          segment_vec = pcb->segment_vector;
-        }
-        else if (type == WEAK_PAIRS_TYPE) {
-          scan_dirty_pointers_page(gc, page_idx, mask);
-          dirty_vec   = (uint32_t*)pcb->dirty_vector;
-          segment_vec = pcb->segment_vector;
-        }
-        else if (type == CODE_TYPE) {
-          scan_dirty_code_page(gc, page_idx);
-          dirty_vec   = (uint32_t*)pcb->dirty_vector;
-          segment_vec = pcb->segment_vector;
-        }
-        else if (page_bits & SCANNABLE_MASK) {
-          ik_abort("unhandled dirty scan for page with segment bits 0x%08x", page_bits);
-	}
+  ikuword_t	block_end;
+  for (page_idx = lo_idx; page_idx < hi_idx; page_idx = block_end) {
+    block_end = page_idx + DIRTY_SCAN_BLOCK_PAGES;
+    if (block_end > hi_idx) {
+      block_end = hi_idx;
+    }
+    {
+      uint32_t	block_dbits = 0;
+      ikuword_t	i;
+      for (i = page_idx; i < block_end; ++i) {
+	block_dbits |= dirty_vec[i];
+      }
+      if (0 == (block_dbits & mask)) {
+	continue;
+      }
+    }
+    for (; page_idx < block_end; ++page_idx) {
+      scan_dirty_page_at_index(gc, page_idx, mask);
+      /* The scan might have  allocated new memory, so we must retake
+	 the dirty vector. */
+      dirty_vec = (uint32_t*)pcb->dirty_vector;
+    }
+  }
+}
+static inline void
+scan_dirty_page_at_index (gc_t* gc, ikuword_t page_idx, uint32_t mask)
+/* Subroutine of  "scan_dirty_pages()".  If  the page  at PAGE_IDX  is a
+   dirty page older than the collected generation: scan it. */
+{
+  uint32_t *	dirty_vec   = (uint32_t*)gc->pcb->dirty_vector;
+  uint32_t *	segment_vec = gc->pcb->segment_vector;
+  uint32_t	collect_gen = gc->collect_gen;
+  if (dirty_vec[page_idx] & mask) {
+    uint32_t page_bits               = segment_vec[page_idx];
+    uint32_t page_generation_number  = page_bits & GEN_MASK;
+    if (page_generation_number > collect_gen) {
+      uint32_t type = page_bits & TYPE_MASK;
+      ++(gc->dirty_pages_scanned);
+      if ((type == POINTERS_TYPE) || (type == SYMBOLS_TYPE) || (type == WEAK_PAIRS_TYPE)) {
+	scan_dirty_pointers_page(gc, page_idx, mask);
+      }
+      else if (type == CODE_TYPE) {
+	scan_dirty_code_page(gc, page_idx);
+      }
+      else if (page_bits & SCANNABLE_MASK) {
+	ik_abort("unhandled dirty scan for page with segment bits 0x%08x", page_bits);
       }
     }
   }
@@ -3177,6 +3699,192 @@ scan_dirty_code_page (gc_t* gc, ikuword_t page_idx)
   }
 }
 
+
+/** --------------------------------------------------------------------
+ ** Garbage collection events log.
+ ** ----------------------------------------------------------------- */
+
+static ik_gc_event_t *
+gc_event_log_ref (ikpcb_t * pcb, ikuword_t idx)
+/* Return a pointer to the record at  index IDX in the events log, where
+   index zero selects the oldest record still in the ring buffer. */
+{
+  ikuword_t	first = (pcb->gc_event_log_count > IK_GC_EVENT_LOG_LENGTH)?
+    (pcb->gc_event_log_count - IK_GC_EVENT_LOG_LENGTH) : 0;
+  return &(pcb->gc_event_log[(first + idx) % IK_GC_EVENT_LOG_LENGTH]);
+}
+static ikuword_t
+gc_event_log_length (ikpcb_t * pcb)
+{
+  return (pcb->gc_event_log_count > IK_GC_EVENT_LOG_LENGTH)?
+    IK_GC_EVENT_LOG_LENGTH : pcb->gc_event_log_count;
+}
+
+/* Number  of 64-bit  words  of  a record  in  the  snapshot returned  by
+   "ikrt_gc_event_log_snapshot()". */
+#define GC_EVENT_SNAPSHOT_WORDS		(6 + IK_GC_EVENT_META_COUNT)
+
+ikptr_t
+ikrt_gc_event_log_snapshot (ikpcb_t * pcb)
+/* Return a bytevector holding a copy of  the records in the events log,
+ * from  the oldest  to the  newest.   Every record  is a  sequence  of
+ * GC_EVENT_SNAPSHOT_WORDS  64-bit  words in  native  endianness:  the
+ * collection id (signed), the generation, the pause in microseconds, the
+ * copied bytes for every meta page type, the freed pages, the scanned
+ * dirty pages, the processed guardians.  Do not change the layout!!!  It
+ * must match the function "gc-event-log" in "scheme/ikarus.timer.sls".
+ *
+ *   The  records  are  copied  in  a  static  buffer  before  allocating the
+ * bytevector: the allocation may  trigger a garbage collection, which adds
+ * a record to the log, and the snapshot must not see it.
+ */
+{
+  static uint64_t	snapshot[IK_GC_EVENT_LOG_LENGTH * GC_EVENT_SNAPSHOT_WORDS];
+  ikuword_t		len = gc_event_log_length(pcb);
+  ikuword_t		idx;
+  ikptr_t		s_bv;
+  for (idx=0; idx<len; ++idx) {
+    ik_gc_event_t *	event = gc_event_log_ref(pcb, idx);
+    uint64_t *		words = &(snapshot[idx * GC_EVENT_SNAPSHOT_WORDS]);
+    int			i;
+    words[0] = (uint64_t)(int64_t)event->collection_id;
+    words[1] = (uint64_t)event->generation;
+    words[2] = (uint64_t)event->pause_usecs;
+    for (i=0; i<IK_GC_EVENT_META_COUNT; ++i) {
+      words[3 + i] = (uint64_t)event->copied_bytes[i];
+    }
+    words[3 + IK_GC_EVENT_META_COUNT] = (uint64_t)event->freed_pages;
+    words[4 + IK_GC_EVENT_META_COUNT] = (uint64_t)event->dirty_pages_scanned;
+    words[5 + IK_GC_EVENT_META_COUNT] = (uint64_t)event->guardians_processed;
+  }
+  s_bv = ika_bytevector_alloc(pcb, len * GC_EVENT_SNAPSHOT_WORDS * sizeof(uint64_t));
+  memcpy(IK_BYTEVECTOR_DATA_VOIDP(s_bv), snapshot, len * GC_EVENT_SNAPSHOT_WORDS * sizeof(uint64_t));
+  return s_bv;
+}
+ikptr_t
+ikrt_gc_event_log_reset (ikpcb_t * pcb)
+{
+  pcb->gc_event_log_count = 0;
+  return IK_VOID_OBJECT;
+}
+ikptr_t
+ikrt_gc_event_log_dump (ikptr_t s_fd, ikpcb_t * pcb)
+/* Write the records in the events log to the file descriptor S_FD, one
+   JSON object per line, from the oldest to the newest.  Return the number
+   of records written or an encoded "errno" value. */
+{
+  static const char * const	meta_names[IK_GC_EVENT_META_COUNT] = {
+    "ptrs", "code", "data", "weak", "pair", "symbol"
+  };
+  int		fd  = IK_NUM_TO_FD(s_fd);
+  ikuword_t	len = gc_event_log_length(pcb);
+  ikuword_t	idx;
+  for (idx=0; idx<len; ++idx) {
+    ik_gc_event_t *	event = gc_event_log_ref(pcb, idx);
+    char		line[1024];
+    int			line_len;
+    int			i;
+    line_len = snprintf(line, sizeof(line),
+			"{\"collection_id\":%d,\"generation\":%d,\"pause_usecs\":%lu,\"copied_bytes\":{",
+			event->collection_id, event->generation, (ik_ulong)event->pause_usecs);
+    for (i=0; i<IK_GC_EVENT_META_COUNT; ++i) {
+      line_len += snprintf(line + line_len, sizeof(line) - line_len, "%s\"%s\":%lu",
+			   (i? "," : ""), meta_names[i], (ik_ulong)event->copied_bytes[i]);
+    }
+    line_len += snprintf(line + line_len, sizeof(line) - line_len,
+			 "},\"freed_pages\":%lu,\"dirty_pages_scanned\":%lu,\"guardians_processed\":%lu}\n",
+			 (ik_ulong)event->freed_pages,
+			 (ik_ulong)event->dirty_pages_scanned,
+			 (ik_ulong)event->guardians_processed);
+    {
+      char *	ptr = line;
+      while (line_len > 0) {
+	ssize_t	rv;
+	errno = 0;
+	rv    = write(fd, ptr, line_len);
+	if (0 <= rv) {
+	  ptr      += rv;
+	  line_len -= rv;
+	} else if (EINTR != errno) {
+	  return ik_errno_to_code();
+	}
+      }
+    }
+  }
+  return IK_FIX(len);
+}
+
+
+/** --------------------------------------------------------------------
+ ** Allocating large strings and bytevectors.
+ ** ----------------------------------------------------------------- */
+
+/* Large strings  and bytevectors are  allocated outside the  nursery, in
+ * their own  run of pages tagged  as "large object" of  the nursery
+ * generation.  The  first collection in which  such an object survives
+ * promotes it by  retagging its pages, so  it is never copied  and the
+ * peak memory usage is not doubled.   Pages of objects that do not survive
+ * are released by "deallocate_unused_pages()".
+ *
+ *   The  bytes  allocated  this  way  do  not  consume  the  nursery,  so
+ * allocating only large objects would never trigger a collection: when the
+ * bytes allocated since  the last run exceed  the size of the nursery, we
+ * run a collection before allocating.
+ */
+
+static ikptr_t
+alloc_large_data (ikpcb_t * pcb, ikuword_t aligned_size)
+/* Allocate a run of pages to store  a large data object of ALIGNED_SIZE
+   bytes; return an untagged pointer to the first page. */
+{
+  ikuword_t	memreq = IK_ALIGN_TO_NEXT_PAGE(aligned_size);
+  ikptr_t	mem;
+  if ((pcb->large_data_bytes_since_gc >= ik_customisable_heap_nursery_size) &&
+      (! ik_garbage_collection_is_forbidden)) {
+    pcb = ik_automatic_collect_from_C(0, pcb);
+  }
+  mem = ik_mmap_typed(memreq, DATA_MT | LARGE_OBJECT_TAG | IK_GC_GENERATION_NURSERY, pcb);
+  pcb->large_data_bytes_since_gc += memreq;
+  /* Reset to zero  the portion of memory  that will not be  used by the
+     large object. */
+  bzero((uint8_t*)(ikuword_t)(mem+aligned_size), memreq-aligned_size);
+  return mem;
+}
+ikptr_t
+ikrt_make_large_bytevector (ikptr_t s_len, ikpcb_t * pcb)
+/* Return a  new bytevector of  S_LEN octets with  unspecified contents.
+   Used by MAKE-BYTEVECTOR  for big  bytevectors;  small ones  are still
+   allocated in the nursery. */
+{
+  ikuword_t	len          = IK_UNFIX(s_len);
+  ikuword_t	aligned_size = IK_ALIGN(disp_bytevector_data + len + 1);
+  ikptr_t	s_bv;
+  if (aligned_size < LARGE_DATA_OBJECT_THRESHOLD) {
+    return ika_bytevector_alloc(pcb, len);
+  }
+  s_bv = alloc_large_data(pcb, aligned_size) | bytevector_tag;
+  IK_REF(s_bv, off_bytevector_length) = s_len;
+  IK_BYTEVECTOR_DATA_CHARP(s_bv)[len] = '\0';
+  return s_bv;
+}
+ikptr_t
+ikrt_make_large_string (ikptr_t s_len, ikpcb_t * pcb)
+/* Return a new string of S_LEN characters with unspecified contents.  Used
+   by MAKE-STRING for big strings; small ones are still allocated in the
+   nursery. */
+{
+  ikuword_t	len          = IK_UNFIX(s_len);
+  ikuword_t	aligned_size = IK_ALIGN(len * IK_STRING_CHAR_SIZE + disp_string_data);
+  ikptr_t	s_str;
+  if (aligned_size < LARGE_DATA_OBJECT_THRESHOLD) {
+    return ika_string_alloc(pcb, len);
+  }
+  s_str = alloc_large_data(pcb, aligned_size) | string_tag;
+  IK_REF(s_str, off_string_length) = s_len;
+  return s_str;
+}
+
+
 
 /** --------------------------------------------------------------------
  ** Miscellaneous functions.
@@ -29,6 +29,7 @@
  ** ----------------------------------------------------------------- */
 
 #include <internals.h>
+#include <signal.h>
 
 
 /** --------------------------------------------------------------------
@@ -151,4 +152,130 @@ ikrt_dummy_arg_9 (ikptr_t arg1, ikptr_t arg2, ikptr_t arg3,
 }
 
 
+
+/** --------------------------------------------------------------------
+ ** Sampling profiler.
+ ** ----------------------------------------------------------------- */
+
+/* The  sampling  profiler takes  samples  at  the  safe points  where  the
+   compiler  has inserted  engine checks.   The SIGPROF  handler sets  the
+   engine counter to -1, so the next engine check calls the Scheme function
+   "$do-event", which  calls the  current engine handler;  the profiler's
+   engine handler  acknowledges the  sample with "ikrt_profiler_sample_pending"
+   and retrieves the code objects of the Scheme stack frames with
+   "ikrt_profiler_stack_code_objects".
+
+   Nothing  is done  in the  signal handler  other than  setting two  words:
+   walking the  stack there  would be unsafe, because  the signal may  be
+   delivered while the garbage collector or a C function is running. */
+
+static volatile sig_atomic_t	profiler_sample_pending = 0;
+
+/* Defined in "ikarus-main.c"; not declared in "internals.h". */
+extern ikpcb_t *	the_pcb;
+
+static void
+profiler_signal_handler (int signo IK_UNUSED)
+/* This is a signal handler: it must  only do async-signal-safe things, so
+   it reads the global "the_pcb" rather than calling "ik_the_pcb()". */
+{
+  ikpcb_t *	pcb = the_pcb;
+  profiler_sample_pending = 1;
+  pcb->engine_counter     = IK_FIX(-1);
+}
+ikptr_t
+ikrt_profiler_start (ikptr_t s_frequency, ikpcb_t * pcb IK_UNUSED)
+/* Start delivering  SIGPROF to the  process S_FREQUENCY times per  second of
+   consumed CPU time.  S_FREQUENCY must be  a fixnum between 1 and 1000000.
+   Return the fixnum zero or an encoded "errno" value. */
+{
+  struct sigaction	sa;
+  struct itimerval	timer;
+  long			usecs = 1000000 / IK_UNFIX(s_frequency);
+  sa.sa_handler = profiler_signal_handler;
+  sa.sa_flags   = SA_RESTART;
+  sigemptyset(&sa.sa_mask);
+  if (sigaction(SIGPROF, &sa, NULL))
+    return ik_errno_to_code();
+  timer.it_interval.tv_sec	= usecs / 1000000;
+  timer.it_interval.tv_usec	= usecs % 1000000;
+  timer.it_value		= timer.it_interval;
+  if (setitimer(ITIMER_PROF, &timer, NULL))
+    return ik_errno_to_code();
+  return IK_FIX(0);
+}
+ikptr_t
+ikrt_profiler_stop (ikpcb_t * pcb IK_UNUSED)
+/* Stop delivering SIGPROF.   The signal is then ignored, because  its default
+   action is to terminate the process and one may still be pending. */
+{
+  struct sigaction	sa;
+  struct itimerval	timer;
+  memset(&timer, 0, sizeof(struct itimerval));
+  setitimer(ITIMER_PROF, &timer, NULL);
+  sa.sa_handler = SIG_IGN;
+  sa.sa_flags   = 0;
+  sigemptyset(&sa.sa_mask);
+  sigaction(SIGPROF, &sa, NULL);
+  profiler_sample_pending = 0;
+  return IK_VOID;
+}
+ikptr_t
+ikrt_profiler_sample_pending (ikpcb_t * pcb IK_UNUSED)
+/* If a sample was requested by the SIGPROF handler: clear the request and
+   return true; otherwise return false. */
+{
+  if (profiler_sample_pending) {
+    profiler_sample_pending = 0;
+    return IK_TRUE;
+  } else
+    return IK_FALSE;
+}
+static long
+profiler_visit_frames (ikptr_t top, ikptr_t end, ikptr_t s_vec, long idx, long max_depth)
+/* Visit the stack  frames from TOP to END; if S_VEC is  not zero: store in it
+   the code objects of the frames, starting at IDX.  Return the new IDX. */
+{
+  for (; (idx < max_depth) && (top < end); ++idx) {
+    ikptr_t	framesize = IK_CALLTABLE_FRAMESIZE(IK_REF(top, 0));
+    if (0 == framesize) {
+      framesize = IK_REF(top, wordsize);
+    }
+    if (s_vec) {
+      IK_ITEM(s_vec, idx) = ik_stack_frame_top_to_code_object(top);
+    }
+    top += framesize;
+  }
+  return idx;
+}
+static long
+profiler_visit_stack (ikpcb_t * pcb, ikptr_t s_vec, long max_depth)
+/* Visit the frames in the current Scheme stack segment, then the frames freezed
+   in the continuation objects  referenced by "pcb->next_k".  Return the number
+   of visited frames. */
+{
+  long		idx = profiler_visit_frames(pcb->frame_pointer, pcb->frame_base - wordsize, s_vec, 0, max_depth);
+  ikptr_t	s_kont;
+  for (s_kont = pcb->next_k; (idx < max_depth) && IK_IS_CONTINUATION(s_kont); s_kont = IK_CONTINUATION_NEXT(s_kont)) {
+    ikptr_t	top = IK_CONTINUATION_TOP(s_kont);
+    idx = profiler_visit_frames(top, top + IK_CONTINUATION_SIZE(s_kont), s_vec, idx, max_depth);
+  }
+  return idx;
+}
+ikptr_t
+ikrt_profiler_stack_code_objects (ikptr_t s_max_depth, ikpcb_t * pcb)
+/* Return  a vector  holding  the code  objects containing  the return  points
+   of the Scheme stack  frames, from the innermost frame to the outermost one;
+   visit at most S_MAX_DEPTH frames. */
+{
+  long		max_depth = IK_UNFIX(s_max_depth);
+  long		depth     = profiler_visit_stack(pcb, 0, max_depth);
+  ikptr_t	s_vec     = ika_vector_alloc_and_init(pcb, depth);
+  /* The allocation may  have run a garbage collection, which  moves the code
+     objects: so we visit the stack again. */
+  profiler_visit_stack(pcb, s_vec, depth);
+  return s_vec;
+}
+
+
 /* end of file */
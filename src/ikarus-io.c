@@ -61,7 +61,15 @@ ikrt_open_input_fd (ikptr_t pathname_bv, ikptr_t ikopts /*, ikpcb_t* pcb */)
   pathname = IK_BYTEVECTOR_DATA_CHARP(pathname_bv);
   errno    = 0;
   fd       = open(pathname, flags, mode);
-  return (0 <= fd)? IK_FD_TO_NUM(fd) : ik_errno_to_code();
+  if (0 <= fd) {
+#ifdef HAVE_POSIX_FADVISE
+    /* Input file ports  are mostly read from  beginning to end: ask  the kernel for
+       aggressive readahead.  This is only a hint, so errors are ignored. */
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+    return IK_FD_TO_NUM(fd);
+  } else
+    return ik_errno_to_code();
 }
 ikptr_t
 ikrt_open_output_fd (ikptr_t pathname_bv, ikptr_t ikopts /*, ikpcb_t* pcb */)
@@ -188,6 +196,32 @@ ikrt_write_fd (ikptr_t fd, ikptr_t buffer_bv, ikptr_t buffer_offset, ikptr_t req
   rv     = write(IK_NUM_TO_FD(fd), buffer, IK_UNFIX(requested_count));
   return (0 <= rv)? IK_FIX(rv) : ik_errno_to_code();
 }
+ikptr_t
+ikrt_write2_fd (ikptr_t fd,
+		ikptr_t head_bv, ikptr_t head_offset, ikptr_t head_count,
+		ikptr_t tail_bv, ikptr_t tail_offset, ikptr_t tail_count /*, ikpcb_t* pcb */)
+/* Write with a  single "writev()" call the  HEAD_COUNT bytes of HEAD_BV  from offset
+   HEAD_OFFSET, followed by the TAIL_COUNT bytes of TAIL_BV from offset TAIL_OFFSET.
+   This allows an output port to send its buffered bytes and a large bytevector without
+   copying the bytevector into the buffer. */
+{
+  struct iovec	iov[2];
+  int		iovcnt = 0;
+  ssize_t	rv;
+  if (IK_UNFIX(head_count)) {
+    iov[iovcnt].iov_base = ((uint8_t *)IK_BYTEVECTOR_DATA_VOIDP(head_bv)) + IK_UNFIX(head_offset);
+    iov[iovcnt].iov_len  = IK_UNFIX(head_count);
+    ++iovcnt;
+  }
+  if (IK_UNFIX(tail_count)) {
+    iov[iovcnt].iov_base = ((uint8_t *)IK_BYTEVECTOR_DATA_VOIDP(tail_bv)) + IK_UNFIX(tail_offset);
+    iov[iovcnt].iov_len  = IK_UNFIX(tail_count);
+    ++iovcnt;
+  }
+  errno  = 0;
+  rv     = writev(IK_NUM_TO_FD(fd), iov, iovcnt);
+  return (0 <= rv)? IK_FIX(rv) : ik_errno_to_code();
+}
 
 
 /** --------------------------------------------------------------------
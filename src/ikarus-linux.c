@@ -67,6 +67,9 @@
 #ifdef HAVE_SYS_RESOURCE_H
 #  include <sys/resource.h>
 #endif
+#ifdef HAVE_SYS_SENDFILE_H
+#  include <sys/sendfile.h>
+#endif
 #ifdef HAVE_SYS_SIGNALFD_H
 #  include <sys/signalfd.h>
 #endif
@@ -88,6 +91,11 @@
 #ifdef HAVE_SYS_WAIT_H
 #  include <sys/wait.h>
 #endif
+#ifdef HAVE_IO_URING
+#  include <sys/syscall.h>
+#  include <sys/uio.h>
+#  include <linux/io_uring.h>
+#endif
 
 /* process identifiers */
 #define IK_PID_TO_NUM(pid)		IK_FIX(pid)
@@ -598,6 +606,612 @@ ikrt_linux_timerfd_read (ikptr_t s_fd, ikpcb_t * pcb)
     return ik_errno_to_code();
 }
 
+
+/** --------------------------------------------------------------------
+ ** Asynchronous I/O with io_uring.
+ ** ----------------------------------------------------------------- */
+
+/* We talk to the kernel with the raw system calls, so that we do not depend
+   on  an  external library.   The  submission  and  completion rings  are
+   mapped in our memory; every submitted operation owns an "operation slot"
+   whose index is the  "user_data" of the  SQE, and a buffer:  one of the
+   buffers registered with the ring if one is free, else a malloc'ed one.
+
+   The  buffers are  not Scheme  bytevectors  because the  garbage collector
+   moves  bytevectors  while  the  kernel  accesses them:  data is  copied
+   from  the bytevector  when  a write  is  prepared, and  to  the bytevector
+   when a read is finished.
+
+   An operation is "in flight" from the time its SQE is prepared to the time
+   its CQE is reaped: meanwhile the kernel may access its buffer, so the ring
+   cannot be released.  Cancellation requests have IK_URING_CANCEL_DATA as
+   "user_data"; their CQEs are discarded. */
+
+#ifdef HAVE_IO_URING
+
+#define IK_URING_CANCEL_DATA	((uint64_t)-1)
+
+typedef struct ik_uring_op_t {
+  uint8_t *	buffer;
+  int		fixed_index;	/* -1 if BUFFER is malloc'ed */
+  uint8_t	in_flight;
+  uint8_t	cancelled;	/* true if a cancellation request was submitted */
+} ik_uring_op_t;
+
+typedef struct ik_uring_t {
+  int			fd;
+  unsigned		sq_entries;
+  unsigned *		sq_head;
+  unsigned *		sq_tail;
+  unsigned *		sq_mask;
+  unsigned *		sq_array;
+  unsigned *		cq_head;
+  unsigned *		cq_tail;
+  unsigned *		cq_mask;
+  struct io_uring_sqe *	sqes;
+  struct io_uring_cqe *	cqes;
+  void *		sq_ring;
+  size_t		sq_ring_size;
+  void *		cq_ring;	/* equal to SQ_RING if single mmap */
+  size_t		cq_ring_size;
+  size_t		sqes_size;
+  unsigned		to_submit;	/* prepared SQEs not yet submitted */
+  /* Operation slots; FREE_OPS is a stack of free slot indexes. */
+  unsigned		ops_count;
+  ik_uring_op_t *	ops;
+  unsigned *		free_ops;
+  unsigned		free_ops_count;
+  unsigned		in_flight_count;
+  /* Registered buffers; FREE_BUFFERS is a stack of free buffer indexes. */
+  size_t		buffer_size;
+  unsigned		buffers_count;
+  uint8_t *		buffers;
+  unsigned *		free_buffers;
+  unsigned		free_buffers_count;
+} ik_uring_t;
+
+static void
+ik_uring_free (ik_uring_t * ring)
+{
+  if (ring->ops) {
+    for (unsigned i=0; i<ring->ops_count; ++i) {
+      if (ring->ops[i].buffer && (-1 == ring->ops[i].fixed_index))
+	free(ring->ops[i].buffer);
+    }
+  }
+  free(ring->ops);
+  free(ring->free_ops);
+  free(ring->buffers);
+  free(ring->free_buffers);
+  if (ring->sqes)
+    munmap(ring->sqes, ring->sqes_size);
+  if (ring->cq_ring && (ring->cq_ring != ring->sq_ring))
+    munmap(ring->cq_ring, ring->cq_ring_size);
+  if (ring->sq_ring)
+    munmap(ring->sq_ring, ring->sq_ring_size);
+  if (-1 != ring->fd)
+    close(ring->fd);
+  free(ring);
+}
+
+static int
+ik_uring_map_rings (ik_uring_t * ring, struct io_uring_params * p)
+{
+  uint8_t *	sq;
+  uint8_t *	cq;
+  ring->sq_ring_size = p->sq_off.array + p->sq_entries * sizeof(unsigned);
+  ring->cq_ring_size = p->cq_off.cqes  + p->cq_entries * sizeof(struct io_uring_cqe);
+  if (p->features & IORING_FEAT_SINGLE_MMAP) {
+    if (ring->cq_ring_size > ring->sq_ring_size)
+      ring->sq_ring_size = ring->cq_ring_size;
+    ring->cq_ring_size = ring->sq_ring_size;
+  }
+  ring->sq_ring = mmap(NULL, ring->sq_ring_size, PROT_READ | PROT_WRITE,
+		       MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQ_RING);
+  if (MAP_FAILED == ring->sq_ring) {
+    ring->sq_ring = NULL;
+    return -1;
+  }
+  if (p->features & IORING_FEAT_SINGLE_MMAP) {
+    ring->cq_ring = ring->sq_ring;
+  } else {
+    ring->cq_ring = mmap(NULL, ring->cq_ring_size, PROT_READ | PROT_WRITE,
+			 MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_CQ_RING);
+    if (MAP_FAILED == ring->cq_ring) {
+      ring->cq_ring = NULL;
+      return -1;
+    }
+  }
+  ring->sqes_size = p->sq_entries * sizeof(struct io_uring_sqe);
+  ring->sqes = mmap(NULL, ring->sqes_size, PROT_READ | PROT_WRITE,
+		    MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQES);
+  if (MAP_FAILED == ring->sqes) {
+    ring->sqes = NULL;
+    return -1;
+  }
+  sq = ring->sq_ring;
+  cq = ring->cq_ring;
+  ring->sq_entries	= p->sq_entries;
+  ring->sq_head		= (unsigned *)(sq + p->sq_off.head);
+  ring->sq_tail		= (unsigned *)(sq + p->sq_off.tail);
+  ring->sq_mask		= (unsigned *)(sq + p->sq_off.ring_mask);
+  ring->sq_array	= (unsigned *)(sq + p->sq_off.array);
+  ring->cq_head		= (unsigned *)(cq + p->cq_off.head);
+  ring->cq_tail		= (unsigned *)(cq + p->cq_off.tail);
+  ring->cq_mask		= (unsigned *)(cq + p->cq_off.ring_mask);
+  ring->cqes		= (struct io_uring_cqe *)(cq + p->cq_off.cqes);
+  return 0;
+}
+
+static void
+ik_uring_register_buffers (ik_uring_t * ring, unsigned count, size_t size)
+/* Allocate and register COUNT buffers of SIZE bytes.  Registration can fail,
+   for example because of RLIMIT_MEMLOCK: in this case we just do without. */
+{
+  struct iovec *	iov;
+  if (0 == count)
+    return;
+  if (posix_memalign((void **)&ring->buffers, (size_t)sysconf(_SC_PAGESIZE), count * size)) {
+    ring->buffers = NULL;
+    return;
+  }
+  iov			= malloc(count * sizeof(struct iovec));
+  ring->free_buffers	= malloc(count * sizeof(unsigned));
+  if (iov && ring->free_buffers) {
+    for (unsigned i=0; i<count; ++i) {
+      iov[i].iov_base		= ring->buffers + i * size;
+      iov[i].iov_len		= size;
+      ring->free_buffers[i]	= count - 1 - i;
+    }
+    if (0 == syscall(__NR_io_uring_register, ring->fd, IORING_REGISTER_BUFFERS, iov, count)) {
+      ring->buffers_count	= count;
+      ring->free_buffers_count	= count;
+      free(iov);
+      return;
+    }
+  }
+  free(iov);
+  free(ring->free_buffers);
+  free(ring->buffers);
+  ring->free_buffers	= NULL;
+  ring->buffers		= NULL;
+}
+
+static struct io_uring_sqe *
+ik_uring_get_sqe (ik_uring_t * ring)
+{
+  unsigned	tail = *ring->sq_tail;
+  unsigned	head = __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE);
+  if (tail - head >= ring->sq_entries)
+    return NULL;
+  else {
+    struct io_uring_sqe *	sqe = &ring->sqes[tail & *ring->sq_mask];
+    memset(sqe, 0, sizeof(struct io_uring_sqe));
+    return sqe;
+  }
+}
+
+static void
+ik_uring_push_sqe (ik_uring_t * ring)
+{
+  unsigned	tail = *ring->sq_tail;
+  unsigned	idx  = tail & *ring->sq_mask;
+  ring->sq_array[idx] = idx;
+  __atomic_store_n(ring->sq_tail, tail + 1, __ATOMIC_RELEASE);
+  ++(ring->to_submit);
+}
+
+static long
+ik_uring_acquire_op (ik_uring_t * ring, size_t * count)
+/* Acquire an operation slot with a buffer for at most *COUNT bytes; update
+   *COUNT with the size of the buffer.  Return the slot index or -1. */
+{
+  unsigned		idx;
+  ik_uring_op_t *	op;
+  if (0 == ring->free_ops_count)
+    return -1;
+  idx = ring->free_ops[ring->free_ops_count - 1];
+  op  = &ring->ops[idx];
+  if (ring->free_buffers_count) {
+    op->fixed_index = (int)ring->free_buffers[ring->free_buffers_count - 1];
+    op->buffer      = ring->buffers + op->fixed_index * ring->buffer_size;
+    if (*count > ring->buffer_size)
+      *count = ring->buffer_size;
+    --(ring->free_buffers_count);
+  } else {
+    op->fixed_index = -1;
+    op->buffer      = malloc(*count? *count : 1);
+    if (NULL == op->buffer)
+      return -1;
+  }
+  --(ring->free_ops_count);
+  return idx;
+}
+
+static void
+ik_uring_release_op (ik_uring_t * ring, unsigned idx)
+{
+  ik_uring_op_t *	op = &ring->ops[idx];
+  if (-1 == op->fixed_index)
+    free(op->buffer);
+  else
+    ring->free_buffers[(ring->free_buffers_count)++] = (unsigned)op->fixed_index;
+  op->buffer = NULL;
+  ring->free_ops[(ring->free_ops_count)++] = idx;
+}
+
+static void
+ik_uring_prep_rw (ik_uring_t * ring, struct io_uring_sqe * sqe, int fixed_opcode, int opcode,
+		  int fd, long op_index, size_t count, ikptr_t s_offset)
+{
+  ik_uring_op_t *	op = &ring->ops[op_index];
+  if (-1 == op->fixed_index) {
+    sqe->opcode		= opcode;
+  } else {
+    sqe->opcode		= fixed_opcode;
+    sqe->buf_index	= (uint16_t)op->fixed_index;
+  }
+  sqe->fd		= fd;
+  sqe->addr		= (uint64_t)(uintptr_t)op->buffer;
+  sqe->len		= (uint32_t)count;
+  /* An offset of -1 means: use (and update) the current file position; this
+     is also what we need for pipes and sockets. */
+  sqe->off		= (IK_FALSE_OBJECT == s_offset)? (uint64_t)-1 : ik_integer_to_uint64(s_offset);
+  sqe->user_data	= (uint64_t)op_index;
+  op->in_flight		= 1;
+  op->cancelled		= 0;
+  ++(ring->in_flight_count);
+  ik_uring_push_sqe(ring);
+}
+
+static int
+ik_uring_enter (ik_uring_t * ring, unsigned min_complete)
+/* Submit the prepared SQEs; if MIN_COMPLETE is positive: wait for at least
+   that number of completions.  Return the number of submitted SQEs or -1 and
+   set "errno". */
+{
+  int	rv = (int)syscall(__NR_io_uring_enter, ring->fd, ring->to_submit, min_complete,
+			  (min_complete? IORING_ENTER_GETEVENTS : 0), NULL, 0);
+  if (-1 != rv)
+    ring->to_submit -= (unsigned)rv;
+  return rv;
+}
+
+static int
+ik_uring_cancel (ik_uring_t * ring)
+/* Submit a cancellation request for every operation in flight not already
+   cancelled; the prepared SQEs are submitted, too.  Return the number of
+   cancellation requests or -1 and set "errno".
+
+   A cancelled operation completes with "-ECANCELED"; an operation the kernel
+   cannot interrupt (for example a  read from a regular file  already started)
+   completes normally. */
+{
+  int	count = 0;
+  for (unsigned i=0; i<ring->ops_count; ++i) {
+    ik_uring_op_t *		op = &ring->ops[i];
+    struct io_uring_sqe *	sqe;
+    if (!op->in_flight || op->cancelled)
+      continue;
+    sqe = ik_uring_get_sqe(ring);
+    if (NULL == sqe) {
+      /* The submission queue is full: make room and retry. */
+      if (-1 == ik_uring_enter(ring, 0))
+	return -1;
+      sqe = ik_uring_get_sqe(ring);
+      if (NULL == sqe)
+	break;
+    }
+    sqe->opcode		= IORING_OP_ASYNC_CANCEL;
+    sqe->fd		= -1;
+    sqe->addr		= (uint64_t)i;
+    sqe->user_data	= IK_URING_CANCEL_DATA;
+    op->cancelled	= 1;
+    ik_uring_push_sqe(ring);
+    ++count;
+  }
+  while (ring->to_submit) {
+    if (-1 == ik_uring_enter(ring, 0)) {
+      if (EINTR != errno)
+	return -1;
+    }
+  }
+  return count;
+}
+
+static int
+ik_uring_drain (ik_uring_t * ring)
+/* Cancel the operations in flight and wait for all their completions, which
+   are discarded.  Return 0 when no operation is in flight, else -1 and set
+   "errno": in this case the ring must not be released. */
+{
+  while (ring->in_flight_count) {
+    if (-1 == ik_uring_cancel(ring))
+      return -1;
+    if ((-1 == ik_uring_enter(ring, 1)) && (EINTR != errno))
+      return -1;
+    {
+      unsigned	head = *ring->cq_head;
+      unsigned	tail = __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE);
+      for (; head != tail; ++head) {
+	uint64_t	data = ring->cqes[head & *ring->cq_mask].user_data;
+	if ((IK_URING_CANCEL_DATA != data) && ring->ops[data].in_flight) {
+	  ring->ops[data].in_flight = 0;
+	  --(ring->in_flight_count);
+	}
+      }
+      __atomic_store_n(ring->cq_head, head, __ATOMIC_RELEASE);
+    }
+  }
+  return 0;
+}
+
+#endif
+
+ikptr_t
+ikrt_linux_uring_setup (ikptr_t s_entries, ikptr_t s_buffers_count, ikptr_t s_buffer_size, ikpcb_t * pcb)
+/* Create a new io_uring instance with at least S_ENTRIES submission entries
+   and try to register S_BUFFERS_COUNT buffers of S_BUFFER_SIZE bytes.  If
+   successful return a pointer object referencing the ring, else return an
+   encoded "errno" value. */
+{
+#ifdef HAVE_IO_URING
+  struct io_uring_params	p;
+  ik_uring_t *			ring;
+  int				fd;
+  memset(&p, 0, sizeof(p));
+  errno = 0;
+  fd    = (int)syscall(__NR_io_uring_setup, (unsigned)IK_UNFIX(s_entries), &p);
+  if (-1 == fd)
+    return ik_errno_to_code();
+  ring = calloc(1, sizeof(ik_uring_t));
+  if (NULL == ring) {
+    close(fd);
+    errno = ENOMEM;
+    return ik_errno_to_code();
+  }
+  ring->fd = fd;
+  if (ik_uring_map_rings(ring, &p)) {
+    ikptr_t	rv = ik_errno_to_code();
+    ik_uring_free(ring);
+    return rv;
+  }
+  /* There cannot be more operations in flight than completion entries. */
+  ring->ops_count	= p.cq_entries;
+  ring->ops		= calloc(ring->ops_count, sizeof(ik_uring_op_t));
+  ring->free_ops	= malloc(ring->ops_count * sizeof(unsigned));
+  if ((NULL == ring->ops) || (NULL == ring->free_ops)) {
+    ik_uring_free(ring);
+    errno = ENOMEM;
+    return ik_errno_to_code();
+  }
+  for (unsigned i=0; i<ring->ops_count; ++i)
+    ring->free_ops[i] = ring->ops_count - 1 - i;
+  ring->free_ops_count	= ring->ops_count;
+  ring->buffer_size	= (size_t)IK_UNFIX(s_buffer_size);
+  ik_uring_register_buffers(ring, (unsigned)IK_UNFIX(s_buffers_count), ring->buffer_size);
+  return ika_pointer_alloc(pcb, (ikuword_t)ring);
+#else
+  feature_failure(__func__);
+#endif
+}
+ikptr_t
+ikrt_linux_uring_close (ikptr_t s_ring)
+/* Release all the resources of the ring referenced by S_RING.  Operations
+   still in flight are cancelled first and their completions are waited for:
+   closing the ring  descriptor does not stop the kernel from accessing their
+   buffers.  Return void, or an  encoded "errno" value if the operations could
+   not be drained; in this case the ring is left open. */
+{
+#ifdef HAVE_IO_URING
+  ik_uring_t *	ring = IK_POINTER_DATA_VOIDP(s_ring);
+  if (ring) {
+    errno = 0;
+    if (ik_uring_drain(ring))
+      return ik_errno_to_code();
+    ik_uring_free(ring);
+    IK_POINTER_SET_NULL(s_ring);
+  }
+  return IK_VOID_OBJECT;
+#else
+  feature_failure(__func__);
+#endif
+}
+ikptr_t
+ikrt_linux_uring_cancel (ikptr_t s_ring)
+/* Submit a cancellation request for every operation in flight; their
+   completions are reaped as usual.  Return the number of cancellation
+   requests or an encoded "errno" value. */
+{
+#ifdef HAVE_IO_URING
+  ik_uring_t *	ring = IK_POINTER_DATA_VOIDP(s_ring);
+  int		rv;
+  errno = 0;
+  rv    = ik_uring_cancel(ring);
+  return (-1 == rv)? ik_errno_to_code() : IK_FIX(rv);
+#else
+  feature_failure(__func__);
+#endif
+}
+ikptr_t
+ikrt_linux_uring_registered_buffers (ikptr_t s_ring)
+/* Return the number of buffers registered with the ring. */
+{
+#ifdef HAVE_IO_URING
+  ik_uring_t *	ring = IK_POINTER_DATA_VOIDP(s_ring);
+  return IK_FIX(ring->buffers_count);
+#else
+  feature_failure(__func__);
+#endif
+}
+ikptr_t
+ikrt_linux_uring_prep_read (ikptr_t s_ring, ikptr_t s_fd, ikptr_t s_count, ikptr_t s_offset)
+/* Prepare a read of at most S_COUNT bytes  from S_FD.  S_OFFSET is false
+   or an exact  integer representing  the file  offset.  Return  the index of
+   the operation slot, or false if no submission entry or operation slot is
+   free. */
+{
+#ifdef HAVE_IO_URING
+  ik_uring_t *		ring  = IK_POINTER_DATA_VOIDP(s_ring);
+  size_t		count = (size_t)IK_UNFIX(s_count);
+  struct io_uring_sqe *	sqe   = ik_uring_get_sqe(ring);
+  long			op_index;
+  if (NULL == sqe)
+    return IK_FALSE_OBJECT;
+  op_index = ik_uring_acquire_op(ring, &count);
+  if (-1 == op_index)
+    return IK_FALSE_OBJECT;
+  ik_uring_prep_rw(ring, sqe, IORING_OP_READ_FIXED, IORING_OP_READ,
+		   IK_NUM_TO_FD(s_fd), op_index, count, s_offset);
+  return IK_FIX(op_index);
+#else
+  feature_failure(__func__);
+#endif
+}
+ikptr_t
+ikrt_linux_uring_prep_write (ikptr_t s_ring, ikptr_t s_fd,
+			     ikptr_t s_bv, ikptr_t s_start, ikptr_t s_count, ikptr_t s_offset)
+/* Prepare a write to S_FD of at most  S_COUNT bytes from the bytevector S_BV,
+   starting at index S_START; the bytes are copied in the buffer of the
+   operation.  S_OFFSET is false or an exact integer representing the file
+   offset.  Return the index  of the  operation slot, or false if  no submission
+   entry or operation slot is free. */
+{
+#ifdef HAVE_IO_URING
+  ik_uring_t *		ring  = IK_POINTER_DATA_VOIDP(s_ring);
+  size_t		count = (size_t)IK_UNFIX(s_count);
+  struct io_uring_sqe *	sqe   = ik_uring_get_sqe(ring);
+  long			op_index;
+  if (NULL == sqe)
+    return IK_FALSE_OBJECT;
+  op_index = ik_uring_acquire_op(ring, &count);
+  if (-1 == op_index)
+    return IK_FALSE_OBJECT;
+  memcpy(ring->ops[op_index].buffer, IK_BYTEVECTOR_DATA_UINT8P(s_bv) + IK_UNFIX(s_start), count);
+  ik_uring_prep_rw(ring, sqe, IORING_OP_WRITE_FIXED, IORING_OP_WRITE,
+		   IK_NUM_TO_FD(s_fd), op_index, count, s_offset);
+  return IK_FIX(op_index);
+#else
+  feature_failure(__func__);
+#endif
+}
+ikptr_t
+ikrt_linux_uring_submit (ikptr_t s_ring, ikptr_t s_min_complete)
+/* Submit all the prepared operations with a single system call; if
+   S_MIN_COMPLETE is positive: wait for at least that number of completions.
+   Return the number of submitted operations or an encoded "errno" value. */
+{
+#ifdef HAVE_IO_URING
+  ik_uring_t *	ring = IK_POINTER_DATA_VOIDP(s_ring);
+  int		rv;
+  errno = 0;
+  rv    = ik_uring_enter(ring, (unsigned)IK_UNFIX(s_min_complete));
+  return (-1 == rv)? ik_errno_to_code() : IK_FIX(rv);
+#else
+  feature_failure(__func__);
+#endif
+}
+ikptr_t
+ikrt_linux_uring_reap (ikptr_t s_ring, ikptr_t s_completions)
+/* Drain the completion queue into the Scheme vector S_COMPLETIONS: for each
+   completion store the  operation index and the result (the number of
+   transferred bytes or a negated "errno" value) as two adjacent fixnums.
+   The completions of cancellation requests are discarded.  Return the number
+   of completions. */
+{
+#ifdef HAVE_IO_URING
+  ik_uring_t *	ring = IK_POINTER_DATA_VOIDP(s_ring);
+  long		max  = IK_VECTOR_LENGTH(s_completions) / 2;
+  unsigned	head = *ring->cq_head;
+  unsigned	tail = __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE);
+  long		count;
+  for (count=0; (head != tail) && (count < max); ++head) {
+    struct io_uring_cqe *	cqe = &ring->cqes[head & *ring->cq_mask];
+    if (IK_URING_CANCEL_DATA == cqe->user_data)
+      continue;
+    ring->ops[cqe->user_data].in_flight = 0;
+    --(ring->in_flight_count);
+    /* Fixnums need no write barrier. */
+    IK_ITEM(s_completions, 2*count)   = IK_FIX((long)cqe->user_data);
+    IK_ITEM(s_completions, 2*count+1) = IK_FIX(cqe->res);
+    ++count;
+  }
+  __atomic_store_n(ring->cq_head, head, __ATOMIC_RELEASE);
+  return IK_FIX(count);
+#else
+  feature_failure(__func__);
+#endif
+}
+ikptr_t
+ikrt_linux_uring_finish (ikptr_t s_ring, ikptr_t s_op, ikptr_t s_bv, ikptr_t s_start, ikptr_t s_count)
+/* Release the  operation slot  S_OP.  If  S_BV is  a bytevector: first copy
+   S_COUNT  bytes from  the buffer  of  the operation  into S_BV, starting at
+   index S_START. */
+{
+#ifdef HAVE_IO_URING
+  ik_uring_t *	ring     = IK_POINTER_DATA_VOIDP(s_ring);
+  unsigned	op_index = (unsigned)IK_UNFIX(s_op);
+  if (IK_FALSE_OBJECT != s_bv)
+    memcpy(IK_BYTEVECTOR_DATA_UINT8P(s_bv) + IK_UNFIX(s_start), ring->ops[op_index].buffer,
+	   (size_t)IK_UNFIX(s_count));
+  ik_uring_release_op(ring, op_index);
+  return IK_VOID_OBJECT;
+#else
+  feature_failure(__func__);
+#endif
+}
+
+
+/** --------------------------------------------------------------------
+ ** Zero-copy data transfer.
+ ** ----------------------------------------------------------------- */
+
+ikptr_t
+ikrt_linux_sendfile (ikptr_t s_out_fd, ikptr_t s_in_fd, ikptr_t s_offset, ikptr_t s_count, ikpcb_t * pcb)
+/* Transfer at most S_COUNT bytes from S_IN_FD  to S_OUT_FD without copying them to
+   user space.  S_OFFSET is false or an exact integer representing the offset in
+   S_IN_FD to read from;  if it is false: the current file position is used and
+   updated.  Return the number of transferred bytes or an encoded "errno" value. */
+{
+#ifdef HAVE_SENDFILE
+  off_t		offset;
+  ssize_t	rv;
+  if (IK_FALSE_OBJECT != s_offset)
+    offset = ik_integer_to_off_t(s_offset);
+  errno = 0;
+  rv    = sendfile(IK_NUM_TO_FD(s_out_fd), IK_NUM_TO_FD(s_in_fd),
+		   (IK_FALSE_OBJECT == s_offset)? NULL : &offset,
+		   ik_integer_to_size_t(s_count));
+  return (0 <= rv)? ika_integer_from_ssize_t(pcb, rv) : ik_errno_to_code();
+#else
+  feature_failure(__func__);
+#endif
+}
+ikptr_t
+ikrt_linux_splice (ikptr_t s_in_fd, ikptr_t s_in_offset, ikptr_t s_out_fd, ikptr_t s_out_offset,
+		   ikptr_t s_count, ikptr_t s_flags, ikpcb_t * pcb)
+/* Move at most S_COUNT bytes from S_IN_FD to S_OUT_FD, one of which must be a pipe,
+   without copying them to user space.  S_IN_OFFSET and S_OUT_OFFSET are false or
+   exact integers,  as for "sendfile()".  Return  the number of transferred bytes or
+   an encoded "errno" value. */
+{
+#ifdef HAVE_SPLICE
+  loff_t	in_offset, out_offset;
+  ssize_t	rv;
+  if (IK_FALSE_OBJECT != s_in_offset)
+    in_offset  = ik_integer_to_off_t(s_in_offset);
+  if (IK_FALSE_OBJECT != s_out_offset)
+    out_offset = ik_integer_to_off_t(s_out_offset);
+  errno = 0;
+  rv    = splice(IK_NUM_TO_FD(s_in_fd),  (IK_FALSE_OBJECT == s_in_offset)?  NULL : &in_offset,
+		 IK_NUM_TO_FD(s_out_fd), (IK_FALSE_OBJECT == s_out_offset)? NULL : &out_offset,
+		 ik_integer_to_size_t(s_count), (unsigned)IK_UNFIX(s_flags));
+  return (0 <= rv)? ika_integer_from_ssize_t(pcb, rv) : ik_errno_to_code();
+#else
+  feature_failure(__func__);
+#endif
+}
+
 
 /** --------------------------------------------------------------------
  ** Platform resources usage and limits.
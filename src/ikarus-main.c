@@ -139,8 +139,10 @@ ikrt_get_argv0_string (ikpcb_t * pcb)
 
 static void
 handler (int signo IK_UNUSED, siginfo_t* info IK_UNUSED, void* uap)
+/* This is a signal handler: it must  only do async-signal-safe things, so
+   it reads the global "the_pcb" rather than calling "ik_the_pcb()". */
 {
-  ikpcb_t *	pcb = ik_the_pcb();
+  ikpcb_t *	pcb = the_pcb;
   /* avoid compiler warnings on unused arguments */
   /* signo=signo; info=info; uap=uap; */
   pcb->engine_counter = IK_FIX(-1);
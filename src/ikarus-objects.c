@@ -274,6 +274,361 @@ ika_bytevector_from_utf16z (ikpcb_t * pcb, const void * _data)
 }
 
 
+/** --------------------------------------------------------------------
+ ** Scheme bytevector bulk operations.
+ ** ----------------------------------------------------------------- */
+
+/* The following functions are called by the Scheme code with "foreign-call";
+   the arguments are validated by the Scheme code.  They are thin wrappers for
+   the C library functions,  which already select at run time  the SSE2 or AVX2
+   implementations when the CPU supports them; the loops of the bitwise
+   operations are simple enough to be vectorised by the C compiler.
+
+   None of these functions allocates Scheme objects. */
+
+ikptr_t
+ikrt_bytevector_move (ikptr_t s_dst, ikptr_t s_dst_start,
+		      ikptr_t s_src, ikptr_t s_src_start,
+		      ikptr_t s_count)
+/* Like "ikrt_bytevector_copy", but the source and destination ranges can
+   overlap. */
+{
+  uint8_t *	dst = IK_BYTEVECTOR_DATA_UINT8P(s_dst) + IK_UNFIX(s_dst_start);
+  uint8_t *	src = IK_BYTEVECTOR_DATA_UINT8P(s_src) + IK_UNFIX(s_src_start);
+  memmove(dst, src, (size_t)IK_UNFIX(s_count));
+  return IK_VOID_OBJECT;
+}
+ikptr_t
+ikrt_bytevector_fill (ikptr_t s_bv, ikptr_t s_start, ikptr_t s_end, ikptr_t s_fill)
+/* Store  the octet  S_FILL, a  fixnum in  the range  [-128, 255], in  the
+   positions of S_BV from S_START inclusive to S_END exclusive. */
+{
+  ikuword_t	start = IK_UNFIX(s_start);
+  memset(IK_BYTEVECTOR_DATA_UINT8P(s_bv) + start,
+	 (uint8_t)IK_UNFIX(s_fill), (size_t)(IK_UNFIX(s_end) - start));
+  return IK_VOID_OBJECT;
+}
+ikptr_t
+ikrt_bytevector_u8_compare (ikptr_t s_bv1, ikptr_t s_bv2)
+/* Compare the octets  of the bytevectors as unsigned  integers, in lexicographic
+   order; a bytevector  which is a prefix  of the other is  less.  Return the
+   fixnum -1, 0 or +1. */
+{
+  ikuword_t	len1 = IK_BYTEVECTOR_LENGTH(s_bv1);
+  ikuword_t	len2 = IK_BYTEVECTOR_LENGTH(s_bv2);
+  int		rv   = memcmp(IK_BYTEVECTOR_DATA_VOIDP(s_bv1),
+			      IK_BYTEVECTOR_DATA_VOIDP(s_bv2),
+			      (len1 < len2)? len1 : len2);
+  if (rv)
+    return (rv < 0)? IK_FIX(-1) : IK_FIX(1);
+  else if (len1 == len2)
+    return IK_FIX(0);
+  else
+    return (len1 < len2)? IK_FIX(-1) : IK_FIX(1);
+}
+ikptr_t
+ikrt_bytevector_index_u8 (ikptr_t s_bv, ikptr_t s_octet, ikptr_t s_start, ikptr_t s_end)
+/* Search the octet S_OCTET, a fixnum  in the range [0, 255], in the positions
+   of S_BV  from S_START inclusive  to S_END exclusive.  Return  the index of
+   the first occurrence or false. */
+{
+  uint8_t *	data  = IK_BYTEVECTOR_DATA_UINT8P(s_bv);
+  ikuword_t	start = IK_UNFIX(s_start);
+  uint8_t *	ptr   = memchr(data + start, (int)IK_UNFIX(s_octet),
+			       (size_t)(IK_UNFIX(s_end) - start));
+  return (ptr)? IK_FIX(ptr - data) : IK_FALSE_OBJECT;
+}
+ikptr_t
+ikrt_bytevector_search (ikptr_t s_bv, ikptr_t s_start, ikptr_t s_end, ikptr_t s_pattern)
+/* Search  the octets  of the  bytevector S_PATTERN in  the positions  of S_BV
+   from S_START inclusive to  S_END exclusive.  Return the index of  the first
+   occurrence or false.  The empty pattern is found at S_START. */
+{
+  uint8_t *	data  = IK_BYTEVECTOR_DATA_UINT8P(s_bv);
+  ikuword_t	start = IK_UNFIX(s_start);
+  uint8_t *	ptr   = memmem(data + start, (size_t)(IK_UNFIX(s_end) - start),
+			       IK_BYTEVECTOR_DATA_VOIDP(s_pattern),
+			       (size_t)IK_BYTEVECTOR_LENGTH(s_pattern));
+  return (ptr)? IK_FIX(ptr - data) : IK_FALSE_OBJECT;
+}
+ikptr_t
+ikrt_bytevector_bitwise (ikptr_t s_operation,
+			 ikptr_t s_src, ikptr_t s_src_start,
+			 ikptr_t s_dst, ikptr_t s_dst_start,
+			 ikptr_t s_count)
+/* Combine S_COUNT octets of S_DST, starting  at S_DST_START, with the octets of
+   S_SRC, starting at S_SRC_START, and store the results in S_DST.  S_OPERATION
+   selects the operation: the fixnum 0 for AND, 1 for inclusive OR, 2 for
+   exclusive OR.  The ranges may be in the same bytevector, but must not
+   overlap unless they are the same range. */
+{
+  uint8_t *	dst   = IK_BYTEVECTOR_DATA_UINT8P(s_dst) + IK_UNFIX(s_dst_start);
+  uint8_t *	src   = IK_BYTEVECTOR_DATA_UINT8P(s_src) + IK_UNFIX(s_src_start);
+  ikuword_t	count = IK_UNFIX(s_count);
+  ikuword_t	i;
+  switch (IK_UNFIX(s_operation)) {
+  case 0:
+    for (i=0; i<count; ++i)
+      dst[i] &= src[i];
+    break;
+  case 1:
+    for (i=0; i<count; ++i)
+      dst[i] |= src[i];
+    break;
+  default:
+    for (i=0; i<count; ++i)
+      dst[i] ^= src[i];
+    break;
+  }
+  return IK_VOID_OBJECT;
+}
+
+
+/** --------------------------------------------------------------------
+ ** Scheme string conversion to and from UTF-8.
+ ** ----------------------------------------------------------------- */
+
+/* The following functions  are called by the Scheme code  with "foreign-call";
+   the arguments are validated by the Scheme code.  They are the fast paths of
+   the conversion functions: runs of ASCII characters are detected 8 octets, or
+   8 characters, at a time and converted with loops the C compiler can
+   vectorise.
+
+   The decoding functions  only accept well-formed UTF-8; when  they find an
+   invalid or incomplete sequence they give up  and leave it to the Scheme code
+   to apply the error handling mode.
+
+   None of these functions allocates Scheme objects. */
+
+#define IK_UTF8_ASCII_MASK	((uint64_t)0x8080808080808080ULL)
+
+/* A character object is ASCII if its code point is less than 128. */
+#define IK_CHAR32_ASCII_LIMIT	((ikchar_t)(0x80 << char_shift))
+
+static inline ikuword_t
+utf8_ascii_prefix_length (const uint8_t * data, ikuword_t len)
+/* Return the number of octets at the beginning of DATA less than 128. */
+{
+  ikuword_t	i = 0;
+  for (; i + 8 <= len; i += 8) {
+    uint64_t	word;
+    memcpy(&word, data + i, 8);
+    if (word & IK_UTF8_ASCII_MASK)
+      break;
+  }
+  for (; i < len && data[i] < 0x80; ++i);
+  return i;
+}
+static inline ikuword_t
+string_ascii_prefix_length (const ikchar_t * data, ikuword_t len)
+/* Return the number of characters at the beginning of DATA whose code point is
+   less than 128. */
+{
+  ikuword_t	i = 0;
+  for (; i + 8 <= len; i += 8) {
+    ikchar_t	bits = 0;
+    int		j;
+    for (j=0; j<8; ++j)
+      bits |= data[i+j];
+    if (bits >= IK_CHAR32_ASCII_LIMIT)
+      break;
+  }
+  for (; i < len && data[i] < IK_CHAR32_ASCII_LIMIT; ++i);
+  return i;
+}
+static inline void
+utf8_widen_ascii (ikchar_t * dst, const uint8_t * src, ikuword_t count)
+{
+  ikuword_t	i;
+  for (i=0; i<count; ++i)
+    dst[i] = IK_CHAR32_FROM_INTEGER(src[i]);
+}
+static inline void
+utf8_narrow_ascii (uint8_t * dst, const ikchar_t * src, ikuword_t count)
+{
+  ikuword_t	i;
+  for (i=0; i<count; ++i)
+    dst[i] = (uint8_t)IK_CHAR32_TO_INTEGER(src[i]);
+}
+static inline int
+utf8_sequence_length (const uint8_t * data, ikuword_t len, uint32_t * code_point)
+/* Validate the multi-octet sequence at the beginning of DATA, which holds LEN
+   octets; the first octet is not ASCII.  If the sequence is well-formed: store
+   its code point in CODE_POINT and return its length.  Otherwise return 0.
+   Overlong encodings, surrogates and code points above #x10FFFF are rejected. */
+{
+  uint8_t	octet0 = data[0];
+  if (0xC2 <= octet0 && octet0 <= 0xDF) {
+    if (len >= 2 && (data[1] & 0xC0) == 0x80) {
+      *code_point = ((octet0 & 0x1F) << 6) | (data[1] & 0x3F);
+      return 2;
+    }
+  } else if (0xE0 <= octet0 && octet0 <= 0xEF) {
+    if (len >= 3 && (data[1] & 0xC0) == 0x80 && (data[2] & 0xC0) == 0x80) {
+      uint32_t	cp = ((octet0 & 0x0F) << 12) | ((data[1] & 0x3F) << 6) | (data[2] & 0x3F);
+      if (0x800 <= cp && (cp < 0xD800 || 0xDFFF < cp)) {
+	*code_point = cp;
+	return 3;
+      }
+    }
+  } else if (0xF0 <= octet0 && octet0 <= 0xF4) {
+    if (len >= 4 && (data[1] & 0xC0) == 0x80 && (data[2] & 0xC0) == 0x80 && (data[3] & 0xC0) == 0x80) {
+      uint32_t	cp = ((octet0 & 0x07) << 18) | ((data[1] & 0x3F) << 12) | ((data[2] & 0x3F) << 6) | (data[3] & 0x3F);
+      if (0x10000 <= cp && cp <= 0x10FFFF) {
+	*code_point = cp;
+	return 4;
+      }
+    }
+  }
+  return 0;
+}
+
+/* ------------------------------------------------------------------ */
+
+ikptr_t
+ikrt_utf8_decoded_length (ikptr_t s_bv, ikptr_t s_start, ikptr_t s_end)
+/* Return a fixnum representing the number of characters encoded by the octets
+   of S_BV from S_START inclusive  to S_END exclusive.  Return false if the
+   octets are not well-formed UTF-8. */
+{
+  const uint8_t *	data = IK_BYTEVECTOR_DATA_UINT8P(s_bv) + IK_UNFIX(s_start);
+  ikuword_t		len  = IK_UNFIX(s_end) - IK_UNFIX(s_start);
+  ikuword_t		i = 0, count = 0;
+  while (i < len) {
+    ikuword_t	run = utf8_ascii_prefix_length(data + i, len - i);
+    i     += run;
+    count += run;
+    if (i < len) {
+      uint32_t	cp;
+      int	seq = utf8_sequence_length(data + i, len - i, &cp);
+      if (0 == seq)
+	return IK_FALSE_OBJECT;
+      i += seq;
+      ++count;
+    }
+  }
+  return IK_FIX(count);
+}
+ikptr_t
+ikrt_utf8_decode (ikptr_t s_bv, ikptr_t s_start, ikptr_t s_end, ikptr_t s_str)
+/* Decode the octets of S_BV from S_START inclusive to S_END exclusive into the
+   string S_STR,  starting at index 0.   The octets must have  been validated by
+   "ikrt_utf8_decoded_length" and S_STR must have the returned length. */
+{
+  const uint8_t *	data = IK_BYTEVECTOR_DATA_UINT8P(s_bv) + IK_UNFIX(s_start);
+  ikuword_t		len  = IK_UNFIX(s_end) - IK_UNFIX(s_start);
+  ikchar_t *		str  = IK_STRING_DATA_IKCHARP(s_str);
+  ikuword_t		i = 0;
+  while (i < len) {
+    ikuword_t	run = utf8_ascii_prefix_length(data + i, len - i);
+    utf8_widen_ascii(str, data + i, run);
+    str += run;
+    i   += run;
+    if (i < len) {
+      uint32_t	cp = 0;
+      i += utf8_sequence_length(data + i, len - i, &cp);
+      *str++ = IK_CHAR32_FROM_INTEGER(cp);
+    }
+  }
+  return IK_VOID_OBJECT;
+}
+ikptr_t
+ikrt_utf8_ascii_run_to_string (ikptr_t s_bv, ikptr_t s_bv_start, ikptr_t s_bv_end,
+			       ikptr_t s_str, ikptr_t s_str_start, ikptr_t s_str_end,
+			       ikptr_t s_stop_at_return)
+/* Store  in  S_STR, starting  at  S_STR_START,  the  characters of  the  ASCII
+   octets of S_BV  starting at S_BV_START.  Stop at the  first non-ASCII octet,
+   at S_BV_END, at S_STR_END and, if S_STOP_AT_RETURN is true, at the first
+   carriage return.  Return a fixnum representing the number of converted
+   octets. */
+{
+  const uint8_t *	src   = IK_BYTEVECTOR_DATA_UINT8P(s_bv) + IK_UNFIX(s_bv_start);
+  ikuword_t		len   = IK_UNFIX(s_bv_end) - IK_UNFIX(s_bv_start);
+  ikuword_t		room  = IK_UNFIX(s_str_end) - IK_UNFIX(s_str_start);
+  ikuword_t		count = utf8_ascii_prefix_length(src, (len < room)? len : room);
+  if (IK_FALSE_OBJECT != s_stop_at_return) {
+    const uint8_t *	ptr = memchr(src, '\r', count);
+    if (ptr)
+      count = ptr - src;
+  }
+  utf8_widen_ascii(IK_STRING_DATA_IKCHARP(s_str) + IK_UNFIX(s_str_start), src, count);
+  return IK_FIX(count);
+}
+
+/* ------------------------------------------------------------------ */
+
+ikptr_t
+ikrt_string_utf8_encoded_length (ikptr_t s_str)
+/* Return a fixnum representing the number of octets in the UTF-8 encoding of
+   S_STR; return false if the number does not fit a fixnum. */
+{
+  const ikchar_t *	data = IK_STRING_DATA_IKCHARP(s_str);
+  ikuword_t		len  = IK_STRING_LENGTH(s_str);
+  ikuword_t		i, count = 0;
+  for (i=0; i<len; ++i) {
+    uint32_t	cp = IK_CHAR32_TO_INTEGER(data[i]);
+    count += 1 + (cp >= 0x80) + (cp >= 0x800) + (cp >= 0x10000);
+  }
+  return (count <= most_positive_fixnum)? IK_FIX(count) : IK_FALSE_OBJECT;
+}
+ikptr_t
+ikrt_string_utf8_encode (ikptr_t s_str, ikptr_t s_bv)
+/* Encode S_STR into the bytevector S_BV, which must have the length returned
+   by "ikrt_string_utf8_encoded_length". */
+{
+  const ikchar_t *	data = IK_STRING_DATA_IKCHARP(s_str);
+  ikuword_t		len  = IK_STRING_LENGTH(s_str);
+  uint8_t *		bv   = IK_BYTEVECTOR_DATA_UINT8P(s_bv);
+  ikuword_t		i = 0;
+  while (i < len) {
+    ikuword_t	run = string_ascii_prefix_length(data + i, len - i);
+    utf8_narrow_ascii(bv, data + i, run);
+    bv += run;
+    i  += run;
+    if (i < len) {
+      uint32_t	cp = IK_CHAR32_TO_INTEGER(data[i++]);
+      if (cp < 0x800) {
+	*bv++ = 0xC0 | (cp >> 6);
+	*bv++ = 0x80 | (cp & 0x3F);
+      } else if (cp < 0x10000) {
+	*bv++ = 0xE0 | (cp >> 12);
+	*bv++ = 0x80 | ((cp >> 6) & 0x3F);
+	*bv++ = 0x80 | (cp & 0x3F);
+      } else {
+	*bv++ = 0xF0 | (cp >> 18);
+	*bv++ = 0x80 | ((cp >> 12) & 0x3F);
+	*bv++ = 0x80 | ((cp >> 6) & 0x3F);
+	*bv++ = 0x80 | (cp & 0x3F);
+      }
+    }
+  }
+  return IK_VOID_OBJECT;
+}
+ikptr_t
+ikrt_string_ascii_run_to_utf8 (ikptr_t s_str, ikptr_t s_str_start, ikptr_t s_str_end,
+			       ikptr_t s_bv, ikptr_t s_bv_start, ikptr_t s_bv_end,
+			       ikptr_t s_stop_at_linefeed)
+/* Store in S_BV, starting at S_BV_START, the octets of the ASCII characters of
+   S_STR starting at S_STR_START.  Stop at the first non-ASCII character, at
+   S_STR_END, at S_BV_END and, if S_STOP_AT_LINEFEED is true, at the first
+   linefeed.  Return a fixnum representing the number of converted characters. */
+{
+  const ikchar_t *	src   = IK_STRING_DATA_IKCHARP(s_str) + IK_UNFIX(s_str_start);
+  ikuword_t		len   = IK_UNFIX(s_str_end) - IK_UNFIX(s_str_start);
+  ikuword_t		room  = IK_UNFIX(s_bv_end) - IK_UNFIX(s_bv_start);
+  ikuword_t		count = string_ascii_prefix_length(src, (len < room)? len : room);
+  if (IK_FALSE_OBJECT != s_stop_at_linefeed) {
+    ikuword_t	i;
+    for (i=0; i<count; ++i)
+      if (IK_CHAR32_FROM_INTEGER('\n') == src[i])
+	break;
+    count = i;
+  }
+  utf8_narrow_ascii(IK_BYTEVECTOR_DATA_UINT8P(s_bv) + IK_UNFIX(s_bv_start), src, count);
+  return IK_FIX(count);
+}
+
+
 /** --------------------------------------------------------------------
  ** Scheme bytevector conversion to ASCII HEX.
  ** ----------------------------------------------------------------- */
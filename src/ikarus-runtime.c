@@ -50,6 +50,15 @@ int		ik_garbage_collection_is_forbidden	= 0;
 ikuword_t	ik_customisable_heap_nursery_size	= IK_HEAPSIZE;
 ikuword_t	ik_customisable_stack_size		= IK_STACKSIZE;
 
+/* Number of threads the garbage collector uses to sweep the page vectors
+   at the end of  a collection run.  When set to 1:  the sweep is serial
+   and no thread is ever created. */
+int		ik_gc_worker_threads			= 1;
+
+/* Policy to select the generation to collect, one among the constants
+   "IK_GC_GENERATION_POLICY_*". */
+int		ik_gc_generation_policy			= IK_GC_GENERATION_POLICY_FIXED;
+
 /* When true: internals inspection messages  are enabled.  It is used by
    the preprocessor macro "IK_RUNTIME_MESSAGE()". */
 int		ik_enabled_runtime_messages		= 0;
@@ -303,6 +312,15 @@ extend_page_vectors_maybe (ikptr_t base_ptr, ikuword_t size, ikpcb_t* pcb)
       pcb->dirty_vector_base = (uint32_t *)new_dvec_base;
       pcb->dirty_vector      = new_dvec_base - new_lo_seg * IK_PAGE_VECTOR_SLOTS_PER_LOGIC_SEGMENT;
     }
+    { /* Allocate a new dirty summary, one byte per segment.  The old bytes
+	 go to the tail of the new summary; the head is set to zero. */
+      uint8_t *	new_summary = ik_malloc(hi_seg - new_lo_seg);
+      bzero(new_summary, old_lo_seg - new_lo_seg);
+      memcpy(new_summary + (old_lo_seg - new_lo_seg), pcb->dirty_summary_base, hi_seg - old_lo_seg);
+      ik_free(pcb->dirty_summary_base, hi_seg - old_lo_seg);
+      pcb->dirty_summary_base = new_summary;
+      pcb->dirty_summary      = (ikptr_t)new_summary - new_lo_seg;
+    }
     { /* Allocate a new  segments vector.  The old slots go  to the tail
 	 of the new vector;  the head of the new vector  is set to zero,
 	 which   means  the   corresponding   pages   are  marked   with
@@ -333,6 +351,15 @@ extend_page_vectors_maybe (ikptr_t base_ptr, ikuword_t size, ikpcb_t* pcb)
       pcb->dirty_vector_base = (uint32_t *)new_dvec_base;
       pcb->dirty_vector      = new_dvec_base - lo_seg * IK_PAGE_VECTOR_SLOTS_PER_LOGIC_SEGMENT;
     }
+    { /* Allocate a new dirty summary, one byte per segment.  The old bytes
+	 go to the head of the new summary; the tail is set to zero. */
+      uint8_t *	new_summary = ik_malloc(new_hi_seg - lo_seg);
+      memcpy(new_summary, pcb->dirty_summary_base, old_hi_seg - lo_seg);
+      bzero(new_summary + (old_hi_seg - lo_seg), new_hi_seg - old_hi_seg);
+      ik_free(pcb->dirty_summary_base, old_hi_seg - lo_seg);
+      pcb->dirty_summary_base = new_summary;
+      pcb->dirty_summary      = (ikptr_t)new_summary - lo_seg;
+    }
     { /* Allocate a new  segments vector.  The old slots go  to the head
 	 of the new vector;  the tail of the new vector  is set to zero,
 	 which   means  the   corresponding   pages   are  marked   with
@@ -355,6 +382,12 @@ ik_make_pcb (void)
   ikpcb_t * pcb = ik_malloc(sizeof(ikpcb_t));
   bzero(pcb, sizeof(ikpcb_t));
 
+  /* Until  we  observe  some  collections:  assume  that  half of  the
+     inspected objects survive. */
+  for (int gen=0; gen<IK_GC_GENERATION_COUNT; ++gen) {
+    pcb->gc_gen_survival_permille[gen] = 500;
+  }
+
   /* The  Scheme heap  grows from  low memory  addresses to  high memory
    * addresses:
    *
@@ -551,6 +584,15 @@ ik_make_pcb (void)
    * like "dirty_vector[734]", where  734 is the value  computed here in
    * "lo_seg_idx".
    *
+   * The dirty summary
+   * -----------------
+   *
+   * The "dirty summary"  is an array of bytes, one  for each logic segment
+   * in the  range of the dirty  vector; a byte is set  to non-zero whenever
+   * a page in its segment is marked  dirty.  Like the dirty vector it is
+   * indexed through  the biased pointer "dirty_summary", with the segment
+   * indexes computed from actual memory addresses.
+   *
    * The segment vector
    * ------------------
    *
@@ -621,6 +663,12 @@ ik_make_pcb (void)
       pcb->dirty_vector_base   = (uint32_t *)dvec;
       pcb->dirty_vector        = dvec - base_offset;
     }
+    {
+      uint8_t *	summary = ik_malloc(hi_seg_idx - lo_seg_idx);
+      bzero(summary, hi_seg_idx - lo_seg_idx);
+      pcb->dirty_summary_base  = summary;
+      pcb->dirty_summary       = (ikptr_t)summary - lo_seg_idx;
+    }
     {
       ikptr_t	svec = ik_mmap(vec_size);
       bzero((char*)svec, vec_size);
@@ -729,6 +777,7 @@ ik_delete_pcb (ikpcb_t* pcb)
     ikuword_t	vec_size = (hi_seg - lo_seg) * IK_PAGE_VECTOR_SLOTS_PER_LOGIC_SEGMENT;
     ik_munmap((ikptr_t)pcb->dirty_vector_base,   vec_size);
     ik_munmap((ikptr_t)pcb->segment_vector_base, vec_size);
+    ik_free(pcb->dirty_summary_base, hi_seg - lo_seg);
   }
   ik_free(pcb, sizeof(ikpcb_t));
 }
@@ -952,6 +1001,50 @@ ikrt_scheme_stack_size_set (ikptr_t s_num_of_bytes, ikpcb_t * pcb)
 
 /* ------------------------------------------------------------------ */
 
+ikptr_t
+ikrt_scheme_gc_worker_threads_ref (ikpcb_t * pcb)
+{
+  return IK_FIX(ik_gc_worker_threads);
+}
+ikptr_t
+ikrt_scheme_gc_worker_threads_set (ikptr_t s_num_of_threads, ikpcb_t * pcb)
+{
+  iksword_t	num_of_threads = IK_UNFIX(s_num_of_threads);
+#ifndef HAVE_PTHREAD
+  /* Without the pthread library the garbage collector is always serial. */
+  num_of_threads = 1;
+#endif
+  if (num_of_threads < 1) {
+    ik_gc_worker_threads = 1;
+  } else if (num_of_threads > IK_GC_MAX_WORKER_THREADS) {
+    ik_gc_worker_threads = IK_GC_MAX_WORKER_THREADS;
+  } else {
+    ik_gc_worker_threads = (int)num_of_threads;
+  }
+  return IK_VOID;
+}
+
+ikptr_t
+ikrt_scheme_gc_generation_policy_ref (ikpcb_t * pcb)
+{
+  return IK_FIX(ik_gc_generation_policy);
+}
+ikptr_t
+ikrt_scheme_gc_generation_policy_set (ikptr_t s_policy, ikpcb_t * pcb)
+{
+  switch (IK_UNFIX(s_policy)) {
+  case IK_GC_GENERATION_POLICY_ADAPTIVE:
+    ik_gc_generation_policy = IK_GC_GENERATION_POLICY_ADAPTIVE;
+    break;
+  default:
+    ik_gc_generation_policy = IK_GC_GENERATION_POLICY_FIXED;
+    break;
+  }
+  return IK_VOID;
+}
+
+/* ------------------------------------------------------------------ */
+
 ikptr_t
 ikrt_automatic_garbage_collection_status (ikpcb_t * pcb)
 {
@@ -1356,6 +1449,19 @@ ikrt_set_code_annotation (ikptr_t s_code, ikptr_t s_annot, ikpcb_t* pcb)
   IK_SIGNAL_DIRT_IN_PAGE_OF_POINTER(pcb, IK_PTR(s_code, off_code_annotation));
   return IK_VOID;
 }
+ikptr_t
+ikrt_code_copy_from_bytevector (ikptr_t s_code, ikptr_t s_bv, ikpcb_t* pcb)
+/* Copy the  octets from the  bytevector S_BV  into the data  area of  the code
+   object S_CODE, starting at offset zero.   The bytevector length must be less
+   than or equal to the code size.  Used by the FASL reader to load the code of
+   compiled libraries  with a  single copy rather  than one octet  at a  time.
+   The data area holds no Scheme objects, so no dirt is signaled. */
+{
+  iksword_t	len = IK_BYTEVECTOR_LENGTH(s_bv);
+  assert(len <= IK_UNFIX(IK_REF(s_code, off_code_code_size)));
+  memcpy((void *)(s_code + off_code_data), IK_BYTEVECTOR_DATA_VOIDP(s_bv), len);
+  return IK_VOID;
+}
 
 
 /** --------------------------------------------------------------------
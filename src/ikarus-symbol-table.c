@@ -23,44 +23,106 @@
 
 #include "internals.h"
 
+static ikptr_t compute_string_hash (ikptr_t str, ikptr_t s_max_len);
+
 #undef NUM_OF_BUCKETS
 #define NUM_OF_BUCKETS		IK_CHUNK_SIZE /* power of 2 */
 
-
+/* The  tables are  enlarged, doubling  the number  of buckets,  when the
+   number of entries  exceeds the number of buckets;  they are never
+   shrunk.  This is the maximum number of buckets. */
+#undef MAX_NUM_OF_BUCKETS
+#define MAX_NUM_OF_BUCKETS	(1 << 24)
+
 static ikptr_t
-make_symbol_table (ikpcb_t* pcb)
+make_symbol_table (ikpcb_t* pcb, ikuword_t number_of_buckets)
 /* Build and return a new hash table to be used as symbol table for both
    common  symbols and  gensyms.   "Symbol table"  here  means a  Scheme
    vector of  buckets, in which  the value  in each bucket  references a
-   proper list  of symbols;  empty bucket slots  are initialised  to the
-   fixnum zero.
+   proper list of entries; empty bucket slots are initialised to the fixnum
+   zero.  NUMBER_OF_BUCKETS must be a power of 2.
+
+   In both tables every entry is a pair whose car is the symbol and whose
+   cdr is the fixnum hash value  of its name (the pretty string for common
+   symbols, the unique  string for gensyms): most lookups  skip non-matching
+   entries without comparing strings.  The table of common symbols is handed
+   to Scheme code after  loading the boot image, which expects the bucket
+   lists to  hold the  symbols themselves: the entries are  stripped by
+   "ikrt_get_symbol_table()".
 
    The vector is allocated outside  of the memory scanned by the garbage
    collector.  Later  some pages in the  vector may be  registered to be
    scanned. */
 {
-  ikuword_t	mem_size = IK_ALIGN_TO_NEXT_PAGE(disp_vector_data + NUM_OF_BUCKETS * wordsize);
+  ikuword_t	mem_size = IK_ALIGN_TO_NEXT_PAGE(disp_vector_data + number_of_buckets * wordsize);
   ikptr_t	s_symtab = ik_mmap_ptr(mem_size, 0, pcb) | vector_tag;
   /* Here we clear the whole allocated  memory block, which is *not* the
      data area of the vector object. */
   memset((char*)(s_symtab+off_vector_length), '\0', mem_size);
-  IK_VECTOR_LENGTH_FX(s_symtab) = IK_FIX(NUM_OF_BUCKETS);
+  IK_VECTOR_LENGTH_FX(s_symtab) = IK_FIX(number_of_buckets);
   return s_symtab;
 }
+static ikptr_t
+enlarge_symbol_table (ikpcb_t * pcb, ikptr_t s_old_table, ik_symbol_table_stats_t * stats)
+/* Build a new  table with double the number of  buckets of S_OLD_TABLE,
+   move  into it  all the  entries and  return it.   The pairs  of the bucket
+   lists are recycled. */
+{
+  ikuword_t	old_len = IK_VECTOR_LENGTH(s_old_table);
+  ikuword_t	new_len = 2 * old_len;
+  ikptr_t	s_new_table = make_symbol_table(pcb, new_len);
+  ikuword_t	i;
+  for (i=0; i<old_len; ++i) {
+    ikptr_t	s_node = IK_ITEM(s_old_table, i);
+    while (s_node && IK_NULL_OBJECT != s_node) {
+      ikptr_t	s_next  = IK_CDR(s_node);
+      ikptr_t	hash_value = IK_UNFIX(IK_CDR(IK_CAR(s_node)));
+      {
+	ikuword_t	bucket_index = hash_value & (new_len - 1);
+	ikptr_t		s_head       = IK_ITEM(s_new_table, bucket_index);
+	/* The new vector is in the youngest generation, but the pair may be
+	   in an older one.  Empty buckets hold  the fixnum zero, which also
+	   terminates the lists. */
+	IK_CDR(s_node) = s_head;
+	IK_SIGNAL_DIRT_IN_PAGE_OF_POINTER(pcb, s_node + off_cdr);
+	IK_ITEM(s_new_table, bucket_index) = s_node;
+      }
+      s_node = s_next;
+    }
+  }
+  ++(stats->resizes);
+  return s_new_table;
+}
+static inline int
+symbol_table_overloaded (ikptr_t s_table, ik_symbol_table_stats_t * stats)
+{
+  ikuword_t	len = IK_VECTOR_LENGTH(s_table);
+  return ((stats->entries > len) && (len < MAX_NUM_OF_BUCKETS));
+}
 ikptr_t
 ikrt_get_symbol_table (ikpcb_t* pcb)
 /* The symbol  table is created by  C language code,  but, after loading
    the  boot  image,  it is  retrieved  by  Scheme  code to  be  handled
-   there. */
+   there.  Scheme code expects the bucket lists to hold the symbols, so we
+   replace every entry with its car. */
 {
   ikptr_t	s_symtab = pcb->symbol_table;
+  ikuword_t	i;
   pcb->symbol_table = IK_FALSE_OBJECT;
   if (IK_FALSE == s_symtab)
     ik_abort("attempt to access dead symbol table");
+  for (i=0; i<IK_VECTOR_LENGTH(s_symtab); ++i) {
+    ikptr_t	s_node = IK_ITEM(s_symtab, i);
+    while (s_node && IK_NULL_OBJECT != s_node) {
+      IK_CAR(s_node) = IK_CAR(IK_CAR(s_node));
+      IK_SIGNAL_DIRT_IN_PAGE_OF_POINTER(pcb, s_node + off_car);
+      s_node = IK_CDR(s_node);
+    }
+  }
   return s_symtab;
 }
 
-
+
 static int
 strings_eqp (ikptr_t s_str1, ikptr_t s_str2)
 {
@@ -74,49 +136,145 @@ strings_eqp (ikptr_t s_str1, ikptr_t s_str2)
 }
 
 
-/* To compute the  hash value of strings and bytevectors  we use at most
-   these number of Scheme characters and bytes from the date area. */
-#undef  HASH_GENERATION_CHARS_LIMIT
-#define HASH_GENERATION_CHARS_LIMIT	64
-#undef  HASH_GENERATION_BYTES_LIMIT
-#define HASH_GENERATION_BYTES_LIMIT	256
+/** --------------------------------------------------------------------
+ ** Hashing strings and bytevectors.
+ ** ----------------------------------------------------------------- */
+
+/* The hash  value of strings and  bytevectors is computed with  a block
+   hash in the style of wyhash  (by Wang Yi, released into the public
+   domain): the data area is consumed  48 or 16 bytes at a time, mixing
+   64-bit words  with  a  64x64->128  bits  multiplication.   When  the
+   maximum number of items is not selected  by the caller: the whole data
+   area is used; so keys sharing a long prefix still have different hash
+   values.
+
+   We read words with "memcpy()" so that unaligned accesses are fine and
+   the compiler can turn them into  single loads.  On platforms with no
+   128-bit integer type the multiplication is performed in 32-bit steps.
+
+   The hash value  is not stored in  boot images nor in  FASL files, so
+   it can change between releases. */
+
+#undef  BLOCK_HASH_SECRET0
+#define BLOCK_HASH_SECRET0	0xa0761d6478bd642fULL
+#undef  BLOCK_HASH_SECRET1
+#define BLOCK_HASH_SECRET1	0xe7037ed1a0b428dbULL
+#undef  BLOCK_HASH_SECRET2
+#define BLOCK_HASH_SECRET2	0x8ebc6af09c88c6e3ULL
+#undef  BLOCK_HASH_SECRET3
+#define BLOCK_HASH_SECRET3	0x589965cc75374cc3ULL
+
+static inline void
+block_hash_mum (uint64_t * A, uint64_t * B)
+/* Multiply *A  by *B; store the  low 64 bits of the  product in *A and
+   the high 64 bits in *B. */
+{
+#ifdef __SIZEOF_INT128__
+  __uint128_t	R = *A;
+  R *= *B;
+  *A = (uint64_t)R;
+  *B = (uint64_t)(R >> 64);
+#else
+  uint64_t	ha = *A >> 32, hb = *B >> 32, la = (uint32_t)*A, lb = (uint32_t)*B;
+  uint64_t	rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+  uint64_t	t  = rl + (rm0 << 32), c = (t < rl);
+  uint64_t	lo = t + (rm1 << 32);
+  c += (lo < t);
+  *A = lo;
+  *B = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+}
+static inline uint64_t
+block_hash_mix (uint64_t A, uint64_t B)
+{
+  block_hash_mum(&A, &B);
+  return A ^ B;
+}
+static inline uint64_t
+block_hash_read8 (const uint8_t * P)
+{
+  uint64_t	V;
+  memcpy(&V, P, 8);
+  return V;
+}
+static inline uint64_t
+block_hash_read4 (const uint8_t * P)
+{
+  uint32_t	V;
+  memcpy(&V, P, 4);
+  return V;
+}
+static uint64_t
+block_hash (const uint8_t * P, size_t len, uint64_t seed)
+/* Compute the hash value of the LEN bytes starting at P. */
+{
+  uint64_t	A, B;
+  seed ^= block_hash_mix(seed ^ BLOCK_HASH_SECRET0, BLOCK_HASH_SECRET1);
+  if (len <= 16) {
+    if (len >= 4) {
+      size_t	off = (len >> 3) << 2;
+      A = (block_hash_read4(P) << 32) | block_hash_read4(P + off);
+      B = (block_hash_read4(P + len - 4) << 32) | block_hash_read4(P + len - 4 - off);
+    } else if (len > 0) {
+      A = (((uint64_t)P[0]) << 16) | (((uint64_t)P[len >> 1]) << 8) | P[len - 1];
+      B = 0;
+    } else {
+      A = B = 0;
+    }
+  } else {
+    size_t	i = len;
+    if (i > 48) {
+      /* Three independent lanes, so that the multiplications can run in
+	 parallel. */
+      uint64_t	see1 = seed, see2 = seed;
+      do {
+	seed = block_hash_mix(block_hash_read8(P)      ^ BLOCK_HASH_SECRET1, block_hash_read8(P +  8) ^ seed);
+	see1 = block_hash_mix(block_hash_read8(P + 16) ^ BLOCK_HASH_SECRET2, block_hash_read8(P + 24) ^ see1);
+	see2 = block_hash_mix(block_hash_read8(P + 32) ^ BLOCK_HASH_SECRET3, block_hash_read8(P + 40) ^ see2);
+	P += 48;
+	i -= 48;
+      } while (i > 48);
+      seed ^= see1 ^ see2;
+    }
+    while (i > 16) {
+      seed = block_hash_mix(block_hash_read8(P) ^ BLOCK_HASH_SECRET1, block_hash_read8(P + 8) ^ seed);
+      P += 16;
+      i -= 16;
+    }
+    A = block_hash_read8(P + i - 16);
+    B = block_hash_read8(P + i - 8);
+  }
+  A ^= BLOCK_HASH_SECRET1;
+  B ^= seed;
+  block_hash_mum(&A, &B);
+  return block_hash_mix(A ^ BLOCK_HASH_SECRET0 ^ len, B ^ BLOCK_HASH_SECRET1);
+}
+static inline ikptr_t
+block_hash_to_fixnum_range (uint64_t H)
+/* Reduce H to a value  that fits in a non-negative fixnum. */
+{
+  ikptr_t	R = (ikptr_t)(H ^ (H >> 32));
+  return ((R << 4) >> 4);
+}
 
 static ikptr_t
 compute_string_hash (ikptr_t str, ikptr_t s_max_len)
-/* one-at-a-time from http://burtleburtle.net/bob/hash/doobs.html */
 {
   ikptr_t	len  = IK_UNFIX(IK_REF(str, off_string_length));
-  ikchar_t *	data = IK_STRING_DATA_IKCHARP(str);
-  ikchar_t *	last;
-  /* With this initialisation: two strings of different length will have
-     different  hash value  even  when  they have  equal  chars used  to
-     compute the hash value. */
-  ikptr_t	H    = len;
+  ikptr_t	limit;
   /* We  expect  S_MAX_LEN to  be:  false,  true, an  already  validated
      non-negative fixnum. */
-  {
-    ikptr_t	limit;
-    if (IK_FALSE == s_max_len) {
-      limit = HASH_GENERATION_CHARS_LIMIT;
-    } else if (IK_TRUE == s_max_len) {
-      limit = len;
-    } else {
-      limit = IK_UNFIX(s_max_len);
-    }
-    last  = data + ((len < limit)? len : limit);
-  }
-  /* one-at-a-time */
-  for (; data < last; ++data) {
-    ikchar_t	c = IK_CHAR32_TO_INTEGER(*data);
-    H = H + c;
-    H = H + (H << 10);
-    H = H ^ (H >> 6);
+  if ((IK_FALSE == s_max_len) || (IK_TRUE == s_max_len)) {
+    limit = len;
+  } else {
+    limit = IK_UNFIX(s_max_len);
   }
-  H = H + (H << 3);
-  H = H ^ (H >> 11);
-  H = H + (H << 15);
-  /* Make it positive. */
-  return ((H << 4) >> 4);
+  /* With this  seed: two strings of  different length will  have different
+     hash value even when they have equal chars used to compute the hash
+     value. */
+  return block_hash_to_fixnum_range(block_hash(IK_STRING_DATA_VOIDP(str),
+					       ((len < limit)? len : limit) * IK_STRING_CHAR_SIZE,
+					       (uint64_t)len));
 }
 ikptr_t
 ikrt_string_hash (ikptr_t str, ikptr_t s_max_len, ikpcb_t * pcb)
@@ -127,41 +285,23 @@ ikptr_t
 ikrt_bytevector_hash (ikptr_t bv, ikptr_t s_max_len, ikpcb_t * pcb)
 {
   ikptr_t	len  = IK_BYTEVECTOR_LENGTH(bv);
-  uint8_t *	data = IK_BYTEVECTOR_DATA_UINT8P(bv);
-  uint8_t *	last;
-  /* With this initialisation: two  bytevectors of different length will
-     have different hash  value even when they have equal  bytes used to
-     compute the hash value. */
-  ikptr_t	H    = len;
+  ikptr_t	limit;
   /* We  expect  S_MAX_LEN to  be:  false,  true, an  already  validated
      non-negative fixnum. */
-  {
-    ikptr_t	limit;
-    if (IK_FALSE == s_max_len) {
-      limit = HASH_GENERATION_BYTES_LIMIT;
-    } else if (IK_TRUE == s_max_len) {
-      limit = len;
-    } else {
-      limit = IK_UNFIX(s_max_len);
-    }
-    last  = data + ((len < limit)? len : limit);
-  }
-  /* one-at-a-time */
-  for (; data < last; ++data) {
-    uint8_t	c = *data;
-    H = H + c;
-    H = H + (H << 10);
-    H = H ^ (H >> 6);
+  if ((IK_FALSE == s_max_len) || (IK_TRUE == s_max_len)) {
+    limit = len;
+  } else {
+    limit = IK_UNFIX(s_max_len);
   }
-  H = H + (H << 3);
-  H = H ^ (H >> 11);
-  H = H + (H << 15);
-  /* Make it positive. */
-  H = ((H << 4) >> 4);
-  return IK_FIX(H);
+  /* With this seed: two bytevectors of different length will have different
+     hash value even when they have equal bytes used to compute the hash
+     value. */
+  return IK_FIX(block_hash_to_fixnum_range(block_hash(IK_BYTEVECTOR_DATA_UINT8P(bv),
+						      ((len < limit)? len : limit),
+						      (uint64_t)len)));
 }
 
-
+
 static ikptr_t
 iku_make_symbol (ikptr_t s_pretty_string, ikptr_t s_unique_string, ikpcb_t* pcb)
 {
@@ -178,76 +318,126 @@ iku_make_symbol (ikptr_t s_pretty_string, ikptr_t s_unique_string, ikpcb_t* pcb)
   return s_sym;
 }
 static ikptr_t
-intern_string (ikptr_t s_unique_string, ikptr_t s_symbol_table, ikpcb_t* pcb)
-/* Notice that all the memory allocations here are UNsafe. */
+intern_string (ikptr_t s_unique_string, ikpcb_t* pcb)
+/* Intern  a  symbol  object  having  S_UNIQUE_STRING as  name  in  the
+   table of common symbols.
+
+   Notice that all the memory allocations here are UNsafe. */
 {
-  int		hash_value    = compute_string_hash(s_unique_string, IK_TRUE);
-  int		bucket_index  = hash_value & (IK_VECTOR_LENGTH(s_symbol_table) - 1);
-  ikptr_t	s_bucket_list = IK_ITEM(s_symbol_table, bucket_index);
+  ik_symbol_table_stats_t *	stats = &(pcb->symbol_table_stats);
+  ikptr_t	s_symbol_table = pcb->symbol_table;
+  ikptr_t	hash_value     = compute_string_hash(s_unique_string, IK_TRUE);
+  ikuword_t	bucket_index   = hash_value & (IK_VECTOR_LENGTH(s_symbol_table) - 1);
+  ikptr_t	s_bucket_list  = IK_ITEM(s_symbol_table, bucket_index);
+  ++(stats->lookups);
   { /* If a symbol having S_UNIQUE_STRING is already interned: return it
        to the caller. */
     ikptr_t	s_list_iterator = s_bucket_list;
     while (s_list_iterator && IK_NULL_OBJECT != s_list_iterator) {
-      ikptr_t	s_sym     = IK_CAR(s_list_iterator);
-      ikptr_t	s_sym_str = IK_REF(s_sym, off_symbol_record_string);
-      if (strings_eqp(s_sym_str, s_unique_string)) {
-	return s_sym;
+      ikptr_t	s_entry = IK_CAR(s_list_iterator);
+      ++(stats->probes);
+      /* Compare the cached hash values first. */
+      if (IK_FIX(hash_value) == IK_CDR(s_entry)) {
+	ikptr_t	s_sym     = IK_CAR(s_entry);
+	ikptr_t	s_sym_str = IK_REF(s_sym, off_symbol_record_string);
+	++(stats->string_comparisons);
+	if (strings_eqp(s_sym_str, s_unique_string)) {
+	  return s_sym;
+	}
       }
       s_list_iterator = IK_CDR(s_list_iterator);
     }
   }
   /* Allocate a new  pointer object and register it  in the symbol table
      by prepending it to the bucket list. */
-  ikptr_t s_sym  = iku_make_symbol(s_unique_string, IK_FALSE_OBJECT, pcb);
-  ikptr_t s_pair = IKU_PAIR_ALLOC(pcb);
-  IK_CAR(s_pair) = s_sym;
-  IK_CDR(s_pair) = s_bucket_list;
+  ikptr_t s_sym   = iku_make_symbol(s_unique_string, IK_FALSE_OBJECT, pcb);
+  ikptr_t s_entry = IKU_PAIR_ALLOC(pcb);
+  ikptr_t s_pair  = IKU_PAIR_ALLOC(pcb);
+  IK_CAR(s_entry) = s_sym;
+  IK_CDR(s_entry) = IK_FIX(hash_value);
+  IK_CAR(s_pair)  = s_entry;
+  IK_CDR(s_pair)  = s_bucket_list;
   IK_ITEM(s_symbol_table, bucket_index) = s_pair;
   { /* Mark the  page containing  the bucket slot  to be scanned  by the
        garbage collector. */
     ikuword_t bucket_slot_pointer = s_symbol_table + off_vector_data + bucket_index * wordsize;
     IK_SIGNAL_DIRT_IN_PAGE_OF_POINTER(pcb, bucket_slot_pointer);
   }
+  ++(stats->entries);
+  if (symbol_table_overloaded(s_symbol_table, stats)) {
+    pcb->symbol_table = enlarge_symbol_table(pcb, s_symbol_table, stats);
+  }
   return s_sym;
 }
 static ikptr_t
-intern_unique_string (ikptr_t s_pretty_string, ikptr_t s_unique_string, ikptr_t s_symbol_table, ikpcb_t* pcb)
-/* Intern a  symbol object, having  S_PRETTY_STRING and S_UNIQUE_STRING,
-   in S_SYMBOL_TABLE which can be  either the common symbol table or the
-   gensyms table.
-
-   If a symbol object having S_UNIQUE_STRING is already interned: return
-   it.  Else: allocate a new symbol object, intern it, return it.
-
-   Notice that all the memory allocations here are UNsafe. */
+gensym_table_lookup (ikptr_t s_unique_string, ikptr_t hash_value, ikpcb_t * pcb)
+/* Search the  table of gensyms for  a symbol having S_UNIQUE_STRING  as
+   unique string; HASH_VALUE must be the hash value of S_UNIQUE_STRING.  If
+   found return the symbol, else return false. */
 {
-  int   hash_value    = compute_string_hash(s_unique_string, IK_TRUE);
-  int   bucket_index  = hash_value & (IK_VECTOR_LENGTH(s_symbol_table) - 1);
-  ikptr_t s_bucket_list = IK_ITEM(s_symbol_table, bucket_index);
-  { /* If a  symbol having  S_UNIQUE_STRING is already  interned, return
-       it. */
-    ikptr_t s_list_iterator = s_bucket_list;
-    while (s_list_iterator && IK_NULL_OBJECT != s_list_iterator) {
-      ikptr_t s_sym      = IK_CAR(s_list_iterator);
-      ikptr_t s_sym_ustr = IK_REF(s_sym, off_symbol_record_ustring);
+  ik_symbol_table_stats_t *	stats = &(pcb->gensym_table_stats);
+  ikptr_t	s_gensym_table  = pcb->gensym_table;
+  ikptr_t	s_list_iterator = IK_ITEM(s_gensym_table, hash_value & (IK_VECTOR_LENGTH(s_gensym_table) - 1));
+  ++(stats->lookups);
+  while (s_list_iterator && IK_NULL_OBJECT != s_list_iterator) {
+    ikptr_t	s_entry = IK_CAR(s_list_iterator);
+    ++(stats->probes);
+    /* Compare the cached hash values first. */
+    if (IK_FIX(hash_value) == IK_CDR(s_entry)) {
+      ikptr_t	s_sym      = IK_CAR(s_entry);
+      ikptr_t	s_sym_ustr = IK_REF(s_sym, off_symbol_record_ustring);
+      ++(stats->string_comparisons);
       if (strings_eqp(s_sym_ustr, s_unique_string)) {
 	return s_sym;
       }
-      s_list_iterator = IK_CDR(s_list_iterator);
     }
+    s_list_iterator = IK_CDR(s_list_iterator);
   }
-  /* Allocate a  new symbol  object and  add it to  the symbol  table by
-     prepending it to the bucket list. */
-  ikptr_t s_sym  = iku_make_symbol(s_pretty_string, s_unique_string, pcb);
-  ikptr_t s_pair = IKU_PAIR_ALLOC(pcb);
-  IK_CAR(s_pair) = s_sym;
-  IK_CDR(s_pair) = s_bucket_list;
-  IK_ITEM(s_symbol_table, bucket_index) = s_pair;
+  return IK_FALSE_OBJECT;
+}
+static void
+gensym_table_insert (ikptr_t s_sym, ikptr_t hash_value, ikpcb_t * pcb)
+/* Add S_SYM to the table of gensyms by prepending it to its bucket list;
+   HASH_VALUE must be the hash value of the unique string of S_SYM.
+
+   Notice that all the memory allocations here are UNsafe. */
+{
+  ik_symbol_table_stats_t *	stats = &(pcb->gensym_table_stats);
+  ikptr_t	s_gensym_table = pcb->gensym_table;
+  ikuword_t	bucket_index   = hash_value & (IK_VECTOR_LENGTH(s_gensym_table) - 1);
+  ikptr_t	s_entry        = IKU_PAIR_ALLOC(pcb);
+  ikptr_t	s_pair         = IKU_PAIR_ALLOC(pcb);
+  IK_CAR(s_entry) = s_sym;
+  IK_CDR(s_entry) = IK_FIX(hash_value);
+  IK_CAR(s_pair)  = s_entry;
+  IK_CDR(s_pair)  = IK_ITEM(s_gensym_table, bucket_index);
+  IK_ITEM(s_gensym_table, bucket_index) = s_pair;
   { /* Mark the  page containing  the bucket slot  to be scanned  by the
        garbage collector. */
-    ikuword_t bucket_slot_pointer = s_symbol_table + off_vector_data + bucket_index * wordsize;
+    ikuword_t bucket_slot_pointer = s_gensym_table + off_vector_data + bucket_index * wordsize;
     IK_SIGNAL_DIRT_IN_PAGE_OF_POINTER(pcb,bucket_slot_pointer);
   }
+  ++(stats->entries);
+  if (symbol_table_overloaded(s_gensym_table, stats)) {
+    pcb->gensym_table = enlarge_symbol_table(pcb, s_gensym_table, stats);
+  }
+}
+static ikptr_t
+intern_unique_string (ikptr_t s_pretty_string, ikptr_t s_unique_string, ikpcb_t* pcb)
+/* Intern a  symbol object, having  S_PRETTY_STRING and S_UNIQUE_STRING,
+   in the table of gensyms.
+
+   If a symbol object having S_UNIQUE_STRING is already interned: return
+   it.  Else: allocate a new symbol object, intern it, return it.
+
+   Notice that all the memory allocations here are UNsafe. */
+{
+  ikptr_t	hash_value = compute_string_hash(s_unique_string, IK_TRUE);
+  ikptr_t	s_sym      = gensym_table_lookup(s_unique_string, hash_value, pcb);
+  if (IK_FALSE_OBJECT == s_sym) {
+    s_sym = iku_make_symbol(s_pretty_string, s_unique_string, pcb);
+    gensym_table_insert(s_sym, hash_value, pcb);
+  }
   return s_sym;
 }
 ikptr_t
@@ -261,38 +451,17 @@ ikrt_intern_gensym (ikptr_t s_sym, ikpcb_t* pcb)
    in a  loop with a  newly generated unique  string stored in  S_SYM at
    each iteration until the interning succeeds. */
 {
-  ikptr_t s_gensym_table = pcb->gensym_table;
-  if (0 == s_gensym_table) {
-    pcb->gensym_table = s_gensym_table = make_symbol_table(pcb);
-  }
-  ikptr_t s_unique_string = IK_REF(s_sym, off_symbol_record_ustring);
-  int   hash_value      = compute_string_hash(s_unique_string, IK_TRUE);
-  int   bucket_index    = hash_value & (IK_VECTOR_LENGTH(s_gensym_table) - 1);
-  ikptr_t s_bucket_list   = IK_ITEM(s_gensym_table, bucket_index);
-  { /* If a  symbol having  S_UNIQUE_STRING is already  interned, return
-       false. */
-    ikptr_t s_list_iterator = s_bucket_list;
-    while (s_list_iterator && IK_NULL_OBJECT != s_list_iterator) {
-      ikptr_t s_sym      = IK_CAR(s_list_iterator);
-      ikptr_t s_sym_ustr = IK_REF(s_sym, off_symbol_record_ustring);
-      if (strings_eqp(s_sym_ustr, s_unique_string)) {
-	return IK_FALSE_OBJECT;
-      }
-      s_list_iterator = IK_CDR(s_list_iterator);
-    }
+  if (0 == pcb->gensym_table) {
+    pcb->gensym_table = make_symbol_table(pcb, NUM_OF_BUCKETS);
   }
-  /* Allocate a  new symbol  object and  add it to  the symbol  table by
-     prepending it to the bucket list. */
-  ikptr_t s_pair = IKU_PAIR_ALLOC(pcb);
-  IK_CAR(s_pair) = s_sym;
-  IK_CDR(s_pair) = s_bucket_list;
-  IK_ITEM(s_gensym_table, bucket_index) = s_pair;
-  { /* Mark the  page containing  the bucket slot  to be scanned  by the
-       garbage collector. */
-    ikuword_t bucket_slot_pointer = s_gensym_table + off_vector_data + bucket_index * wordsize;
-    IK_SIGNAL_DIRT_IN_PAGE_OF_POINTER(pcb,bucket_slot_pointer);
+  ikptr_t	s_unique_string = IK_REF(s_sym, off_symbol_record_ustring);
+  ikptr_t	hash_value      = compute_string_hash(s_unique_string, IK_TRUE);
+  if (IK_FALSE_OBJECT != gensym_table_lookup(s_unique_string, hash_value, pcb)) {
+    return IK_FALSE_OBJECT;
+  } else {
+    gensym_table_insert(s_sym, hash_value, pcb);
+    return IK_TRUE_OBJECT;
   }
-  return IK_TRUE_OBJECT;
 }
 ikptr_t
 ikrt_unintern_gensym (ikptr_t s_sym, ikpcb_t* pcb)
@@ -310,57 +479,36 @@ ikrt_unintern_gensym (ikptr_t s_sym, ikpcb_t* pcb)
   if (IK_TAGOF(s_unique_string) != string_tag) {
     return IK_FALSE_OBJECT;
   }
-  int   hash_value    = compute_string_hash(s_unique_string, IK_TRUE);
-  int   bucket_index  = hash_value & (IK_VECTOR_LENGTH(gensym_table) - 1);
-#if 0
-  /* This  is the  original  Ikarus  code.  (Marco  Maggi;  Sun Mar  11,
-     2012) */
-  ikptr_t bucket_list_pointer = (ikptr_t)(gensym_table + off_vector_data + bucket_index * wordsize);
-  ikptr_t s_bucket_list       = IK_REF(bucket_list_pointer, 0);
-  while (s_bucket_list) {
-    if (IK_CAR(s_bucket_list) == s_sym) {
-      /* Found it.   Remove the unique  string from the  gensym.  Remove
-	 the containing pair from the bucket list. */
-      IK_REF(s_sym, off_symbol_record_ustring) = IK_TRUE_OBJECT;
-      IK_REF(bucket_list_pointer, 0) = IK_CDR(s_bucket_list);
-      return IK_TRUE_OBJECT;
-    } else {
-      bucket_list_pointer = (ikptr_t)(s_bucket_list + off_cdr);
-      s_bucket_list       = IK_REF(bucket_list_pointer, 0);
-    }
-  }
-#else
-  /* This is  the modified  code to make  things more  readable.  (Marco
-     Maggi; Sun Mar 11, 2012) */
-  ikptr_t * bucket_list_pointer = (ikptr_t *)(gensym_table + off_vector_data + bucket_index * wordsize);
-  ikptr_t   s_bucket_list       = *bucket_list_pointer;
-  while (s_bucket_list) {
-    if (IK_CAR(s_bucket_list) == s_sym) {
+  ikptr_t	hash_value    = compute_string_hash(s_unique_string, IK_TRUE);
+  ikuword_t	bucket_index  = hash_value & (IK_VECTOR_LENGTH(gensym_table) - 1);
+  ikptr_t *	bucket_list_pointer = (ikptr_t *)(gensym_table + off_vector_data + bucket_index * wordsize);
+  ikptr_t	s_bucket_list       = *bucket_list_pointer;
+  while (s_bucket_list && IK_NULL_OBJECT != s_bucket_list) {
+    if (IK_CAR(IK_CAR(s_bucket_list)) == s_sym) {
       /* Found it.   Remove the unique  string from the  gensym.  Remove
 	 the containing pair from the bucket list. */
       IK_REF(s_sym, off_symbol_record_ustring) = IK_TRUE_OBJECT;
       *bucket_list_pointer = IK_CDR(s_bucket_list);
+      --(pcb->gensym_table_stats.entries);
       return IK_TRUE_OBJECT;
     } else {
       bucket_list_pointer = (ikptr_t *)(s_bucket_list + off_cdr);
       s_bucket_list       = *bucket_list_pointer;
     }
   }
-#endif
   return IK_FALSE_OBJECT;
 }
 
-
+
 ikptr_t
 iku_string_to_symbol (ikpcb_t * pcb, ikptr_t str)
 {
-  ikptr_t s_symbol_table = pcb->symbol_table;
-  if (IK_FALSE_OBJECT == s_symbol_table)
+  if (IK_FALSE_OBJECT == pcb->symbol_table)
     ik_abort("attempt to access dead symbol table");
-  if (0 == s_symbol_table) {
-    pcb->symbol_table = s_symbol_table = make_symbol_table(pcb);
+  if (0 == pcb->symbol_table) {
+    pcb->symbol_table = make_symbol_table(pcb, NUM_OF_BUCKETS);
   }
-  return intern_string(str, s_symbol_table, pcb);
+  return intern_string(str, pcb);
 }
 ikptr_t
 iku_symbol_from_string (ikpcb_t* pcb, ikptr_t s_str)
@@ -378,11 +526,78 @@ ikrt_string_to_symbol (ikptr_t str, ikpcb_t* pcb)
 ikptr_t
 ikrt_strings_to_gensym (ikptr_t s_pretty_string, ikptr_t s_unique_string, ikpcb_t* pcb)
 {
-  ikptr_t s_gensym_table = pcb->gensym_table;
-  if (0 == s_gensym_table) {
-    pcb->gensym_table = s_gensym_table = make_symbol_table(pcb);
+  if (0 == pcb->gensym_table) {
+    pcb->gensym_table = make_symbol_table(pcb, NUM_OF_BUCKETS);
+  }
+  return intern_unique_string(s_pretty_string, s_unique_string, pcb);
+}
+
+
+/** --------------------------------------------------------------------
+ ** Statistics.
+ ** ----------------------------------------------------------------- */
+
+ikptr_t
+ikrt_symbol_table_statistics (ikptr_t s_gensyms_p, ikptr_t s_vec, ikpcb_t * pcb)
+/* Fill  the vector  S_VEC  with  statistics about  the  table of  common
+   symbols, if  S_GENSYMS_P  is false,  or  about the  table of  gensyms,
+   if S_GENSYMS_P is true.  Return S_VEC or false if the table does not
+   exist or it has already been handed to Scheme code.
+
+   Do not  change the order of  the slots!!!  It must match the functions
+   "$gensym-table-statistics"  and  "$symbol-table-statistics"  in
+   "scheme/ikarus.symbol-table.sls":
+
+      0 - number of buckets
+      1 - number of entries
+      2 - number of non-empty buckets
+      3 - length of the longest bucket list
+      4 - number of lookups
+      5 - number of bucket list entries visited by the lookups
+      6 - number of string comparisons performed by the lookups
+      7 - number of times the table has been enlarged
+
+   The values may be bignums, so we register S_VEC as root. */
+{
+  int				gensyms_p = (IK_FALSE_OBJECT != s_gensyms_p);
+  ikptr_t			s_table   = (gensyms_p)? pcb->gensym_table : pcb->symbol_table;
+  ik_symbol_table_stats_t *	stats     = (gensyms_p)? &(pcb->gensym_table_stats) : &(pcb->symbol_table_stats);
+  ikuword_t			values[8];
+  ikuword_t			i;
+  if ((0 == s_table) || (IK_FALSE_OBJECT == s_table)) {
+    return IK_FALSE_OBJECT;
+  }
+  values[0] = IK_VECTOR_LENGTH(s_table);
+  values[1] = stats->entries;
+  values[2] = 0;
+  values[3] = 0;
+  values[4] = stats->lookups;
+  values[5] = stats->probes;
+  values[6] = stats->string_comparisons;
+  values[7] = stats->resizes;
+  for (i=0; i<values[0]; ++i) {
+    ikptr_t	s_node = IK_ITEM(s_table, i);
+    ikuword_t	len    = 0;
+    while (s_node && IK_NULL_OBJECT != s_node) {
+      ++len;
+      s_node = IK_CDR(s_node);
+    }
+    if (len) {
+      ++values[2];
+      if (len > values[3]) {
+	values[3] = len;
+      }
+    }
+  }
+  pcb->root0 = &s_vec;
+  {
+    for (i=0; i<8; ++i) {
+      IK_ASS(IK_ITEM(s_vec, i), ika_integer_from_ulong(pcb, values[i]));
+      IK_SIGNAL_DIRT_IN_PAGE_OF_POINTER(pcb, IK_ITEM_PTR(s_vec, i));
+    }
   }
-  return intern_unique_string(s_pretty_string, s_unique_string, s_gensym_table, pcb);
+  pcb->root0 = NULL;
+  return s_vec;
 }
 
 /* end of file */
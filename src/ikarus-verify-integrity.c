@@ -69,6 +69,17 @@ ik_verify_integrity (ikpcb_t* pcb, char * when_description)
   for (uint8_t * mem = mem_base; mem < mem_end;) {
     mem = verify_page(mem, mem_base, segment_vec, dirty_vec);
   }
+  /* Every page marked in the dirty vector must be in a segment marked in
+     the dirty summary, otherwise "scan_dirty_pages()" would skip it. */
+  if (pcb->dirty_summary_trusted) {
+    for (ikuword_t i = page_idx(mem_base); i < page_idx(mem_end); ++i) {
+      if ((IK_PURE_WORD != ((uint32_t *)pcb->dirty_vector)[i]) &&
+	  (IK_PURE_SUMMARY_BYTE == ((uint8_t *)pcb->dirty_summary)[i / IK_NUMBER_OF_PAGES_PER_SEGMENT])) {
+	ik_abort("%s: dirty page 0x%016lx in segment not marked in the dirty summary",
+		 __func__, (ik_ulong)(i << IK_PAGESHIFT));
+      }
+    }
+  }
   if (LOG_VERIFY) {
     ik_debug_message("%s: verify_ok in %s", __func__, when_description);
   }
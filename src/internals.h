@@ -398,8 +398,17 @@
    generation. */
 #define IK_PURE_WORD	0x00000000
 #define IK_DIRTY_WORD	0xFFFFFFFF
-#define IK_SIGNAL_DIRT_IN_PAGE_OF_POINTER(PCB,POINTER)	\
-  (((uint32_t *)((PCB)->dirty_vector))[IK_PAGE_INDEX(POINTER)] = IK_DIRTY_WORD)
+
+/* The dirty summary has a byte for every logic segment in the memory
+   described by the  dirty vector; the byte is set to IK_DIRTY_SUMMARY_BYTE
+   whenever a page  in the segment is marked dirty, so the garbage collector
+   needs to visit only the dirty vector slots of marked segments. */
+#define IK_PURE_SUMMARY_BYTE	0x00
+#define IK_DIRTY_SUMMARY_BYTE	0x01
+
+#define IK_SIGNAL_DIRT_IN_PAGE_OF_POINTER(PCB,POINTER)					\
+  ((((uint32_t *)((PCB)->dirty_vector))[IK_PAGE_INDEX(POINTER)]     = IK_DIRTY_WORD),	\
+   (((uint8_t  *)((PCB)->dirty_summary))[IK_SEGMENT_INDEX(POINTER)] = IK_DIRTY_SUMMARY_BYTE))
 
 
 /** --------------------------------------------------------------------
@@ -411,6 +420,16 @@
 #define IK_GC_GENERATION_NURSERY	0
 #define IK_GC_GENERATION_OLDEST		(IK_GC_GENERATION_COUNT - 1)
 
+/* Upper limit  for the  number of  threads the  garbage collector  uses to
+   sweep the page vectors.  See "ik_gc_worker_threads". */
+#define IK_GC_MAX_WORKER_THREADS	64
+
+/* Policies  to  select the  generation  to  collect when  the  garbage
+   collection is not requested for  a specific generation.  See the field
+   "collection_id" of the PCB and "ik_gc_generation_policy". */
+#define IK_GC_GENERATION_POLICY_FIXED		0
+#define IK_GC_GENERATION_POLICY_ADAPTIVE	1
+
 /* The PCB's segments  vector is an array of 32-bit  words, each being a
  * bit field  representing the status  of an allocated memory  page.  We
  * logic  AND  the following  masks  to  such  32-bit words  to  extract
@@ -607,6 +626,40 @@ typedef struct ik_ptr_page_t {
   ikptr_t		ptr[IK_PTR_PAGE_NUMBER_OF_GUARDIANS_SLOTS];
 } ik_ptr_page_t;
 
+/* Record  describing  a  garbage  collection  run;  the  PCB  holds the
+   records of  the last IK_GC_EVENT_LOG_LENGTH  runs in the  ring buffer
+   "gc_event_log".  The  array "copied_bytes"  is indexed by  the "meta"
+   page types of "ikarus-collect.c":  pointers, code, data, weak pairs,
+   pairs, symbols. */
+#define IK_GC_EVENT_LOG_LENGTH		256
+#define IK_GC_EVENT_META_COUNT		6
+typedef struct ik_gc_event_t {
+  int			collection_id;
+  int			generation;
+  ikuword_t		pause_usecs;
+  ikuword_t		copied_bytes[IK_GC_EVENT_META_COUNT];
+  ikuword_t		freed_pages;
+  ikuword_t		dirty_pages_scanned;
+  ikuword_t		guardians_processed;
+} ik_gc_event_t;
+
+/* Counters  describing  the  use  of  a symbol  table  managed  by  "ikarus-
+   symbol-table.c";  the  PCB  holds  one  for  the symbol  table  and  one for
+   the gensym table. */
+typedef struct ik_symbol_table_stats_t {
+  /* Number of entries in the table. */
+  ikuword_t		entries;
+  /* Number of lookups performed so far, both successful and not. */
+  ikuword_t		lookups;
+  /* Number of chain entries visited by the lookups. */
+  ikuword_t		probes;
+  /* Number of string comparisons  performed by the lookups; the difference
+     with "probes" is the number of entries skipped by the cached hash. */
+  ikuword_t		string_comparisons;
+  /* Number of times the table has been enlarged. */
+  ikuword_t		resizes;
+} ik_symbol_table_stats_t;
+
 /* For  more  documentation  on  the PCB  structure:  see  the  function
    "ik_make_pcb()". */
 typedef struct ikpcb_t {
@@ -625,6 +678,7 @@ typedef struct ikpcb_t {
   ikptr_t	  interrupted;		/* offset = 10 * wordsize, 32-bit offset = 40 */
   ikptr_t	  base_rtd;		/* offset = 11 * wordsize, 32-bit offset = 44 */
   ikptr_t	  collect_key;		/* offset = 12 * wordsize, 32-bit offset = 48 */
+  ikptr_t	  dirty_summary;	/* offset = 13 * wordsize, 32-bit offset = 52 */
 
   /* -------------------------------------------------------------------
    * The following  fields are  not used  by any  scheme code  they only
@@ -691,6 +745,25 @@ typedef struct ikpcb_t {
    */
   uint32_t *		dirty_vector_base;
 
+  /* The dirty summary contains a byte for every logic segment in the region
+   * of memory  delimited by "memory_base" and "memory_end";  the byte is
+   * set whenever  a page in the  segment is marked in the  dirty vector.
+   * "scan_dirty_pages()"  visits  only the  dirty  vector  slots  of the
+   * segments with a non-zero byte, and clears the byte when no page of the
+   * segment is left dirty.
+   *
+   *   "dirty_summary_base" references the first allocated byte; access to
+   * the summary with  segment indexes is performed through  the field
+   * "dirty_summary" (which is also accessible from Scheme code).
+   *
+   *   The summary  is updated by code  compiled with  a write barrier that
+   * knows about it; "dirty_summary_trusted" is set to true by the boot
+   * image to  tell the garbage collector  that all its code  does so.  When
+   * false: the collector visits the whole dirty vector.
+   */
+  uint8_t *		dirty_summary_base;
+  int			dirty_summary_trusted;
+
   /* Scheme objects  created by  a Scheme program  are allocated  on the
    * heap.  We can think of the Scheme  heap as the union of the nursery
    * and a set of generational pages.
@@ -876,6 +949,9 @@ typedef struct ikpcb_t {
    *    (0 != (collection_id & #b00111111)) => generation 3
    *    (0 != (collection_id & #b00001111)) => generation 2
    *    (0 != (collection_id & #b00000011)) => generation 1
+   *
+   * this  is  the  "fixed" policy;  when  the  "adaptive" policy  is
+   * selected: see the fields "gc_gen_pending_bytes" and following.
    */
   int			collection_id;
 
@@ -902,6 +978,41 @@ typedef struct ikpcb_t {
   /* Collection of objects not to be collected. */
   void *		not_to_be_collected;
 
+  /* Statistics  used by  the  "adaptive" generation  scheduling  policy;
+   * all the arrays are indexed by generation number.
+   *
+   * gc_gen_pending_bytes -
+   *     Number of bytes promoted into  each generation since the last time
+   *     the generation itself was collected.
+   *
+   * gc_gen_survival_permille -
+   *     Smoothed  ratio,  in  thousandths,   between  the  number  of bytes
+   *     surviving and the number of bytes  inspected the last times a given
+   *     generation was collected.
+   *
+   * gc_live_bytes_after_full -
+   *     Number of bytes that survived the last collection of the oldest
+   *     generation.
+   */
+  ikuword_t		gc_gen_pending_bytes[IK_GC_GENERATION_COUNT];
+  ikuword_t		gc_gen_survival_permille[IK_GC_GENERATION_COUNT];
+  ikuword_t		gc_live_bytes_after_full;
+
+  /* Ring buffer of  garbage collection records.  "gc_event_log_count"
+     is the  total number of records  appended so far: the  next record
+     goes in the slot at index "gc_event_log_count % IK_GC_EVENT_LOG_LENGTH". */
+  ik_gc_event_t		gc_event_log[IK_GC_EVENT_LOG_LENGTH];
+  ikuword_t		gc_event_log_count;
+
+  /* Number of bytes  of large strings and  bytevectors allocated outside
+     the nursery since the last garbage collection. */
+  ikuword_t		large_data_bytes_since_gc;
+
+  /* Usage counters for the tables in the fields "symbol_table" and
+     "gensym_table". */
+  ik_symbol_table_stats_t	symbol_table_stats;
+  ik_symbol_table_stats_t	gensym_table_stats;
+
 } ikpcb_t;
 
 /* The garbage collection avoidance list  is a linked list of structures
@@ -1673,6 +1784,30 @@ ik_decl ikptr_t ika_bytevector_from_utf16z	(ikpcb_t * pcb, const void * data);
 ik_decl ikptr_t ikrt_bytevector_copy (ikptr_t s_dst, ikptr_t s_dst_start,
 				    ikptr_t s_src, ikptr_t s_src_start,
 				    ikptr_t s_count);
+ik_decl ikptr_t ikrt_bytevector_move (ikptr_t s_dst, ikptr_t s_dst_start,
+				    ikptr_t s_src, ikptr_t s_src_start,
+				    ikptr_t s_count);
+ik_decl ikptr_t ikrt_bytevector_fill (ikptr_t s_bv, ikptr_t s_start, ikptr_t s_end, ikptr_t s_fill);
+ik_decl ikptr_t ikrt_bytevector_u8_compare (ikptr_t s_bv1, ikptr_t s_bv2);
+ik_decl ikptr_t ikrt_bytevector_index_u8 (ikptr_t s_bv, ikptr_t s_octet,
+					ikptr_t s_start, ikptr_t s_end);
+ik_decl ikptr_t ikrt_bytevector_search (ikptr_t s_bv, ikptr_t s_start, ikptr_t s_end,
+				      ikptr_t s_pattern);
+ik_decl ikptr_t ikrt_bytevector_bitwise (ikptr_t s_operation,
+				       ikptr_t s_src, ikptr_t s_src_start,
+				       ikptr_t s_dst, ikptr_t s_dst_start,
+				       ikptr_t s_count);
+
+ik_decl ikptr_t ikrt_utf8_decoded_length (ikptr_t s_bv, ikptr_t s_start, ikptr_t s_end);
+ik_decl ikptr_t ikrt_utf8_decode (ikptr_t s_bv, ikptr_t s_start, ikptr_t s_end, ikptr_t s_str);
+ik_decl ikptr_t ikrt_utf8_ascii_run_to_string (ikptr_t s_bv, ikptr_t s_bv_start, ikptr_t s_bv_end,
+					     ikptr_t s_str, ikptr_t s_str_start, ikptr_t s_str_end,
+					     ikptr_t s_stop_at_return);
+ik_decl ikptr_t ikrt_string_utf8_encoded_length (ikptr_t s_str);
+ik_decl ikptr_t ikrt_string_utf8_encode (ikptr_t s_str, ikptr_t s_bv);
+ik_decl ikptr_t ikrt_string_ascii_run_to_utf8 (ikptr_t s_str, ikptr_t s_str_start, ikptr_t s_str_end,
+					     ikptr_t s_bv, ikptr_t s_bv_start, ikptr_t s_bv_end,
+					     ikptr_t s_stop_at_linefeed);
 
 #define IK_BYTEVECTOR_LENGTH_FX(BV)	IK_REF((BV), off_bytevector_length)
 #define IK_BYTEVECTOR_LENGTH(BV)	IK_UNFIX(IK_BYTEVECTOR_LENGTH_FX(BV))
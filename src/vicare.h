@@ -163,6 +163,7 @@ typedef struct ikpcb_t {
   ikptr_t		dummy10;	/* ikptr_t interrupted; */
   ikptr_t		dummy11;	/* ikptr_t base_rtd; */
   ikptr_t		dummy12;	/* ikptr_t collect_key; */
+  ikptr_t		dummy13;	/* ikptr_t dirty_summary; */
 
   /* Additional roots for the garbage collector.  They are used to avoid
      collecting objects still in use while they are in use by C code. */